@@ -5,6 +5,418 @@
 
 using namespace Rcpp;
 
+// buildAtlas
+List buildAtlas(std::vector<std::string> paths, int padding, int maxSize, bool mipmaps);
+RcppExport SEXP _ropengl_buildAtlas(SEXP pathsSEXP, SEXP paddingSEXP, SEXP maxSizeSEXP, SEXP mipmapsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type paths(pathsSEXP);
+    Rcpp::traits::input_parameter< int >::type padding(paddingSEXP);
+    Rcpp::traits::input_parameter< int >::type maxSize(maxSizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type mipmaps(mipmapsSEXP);
+    rcpp_result_gen = Rcpp::wrap(buildAtlas(paths, padding, maxSize, mipmaps));
+    return rcpp_result_gen;
+END_RCPP
+}
+// compressTexture
+unsigned int compressTexture(std::string path, std::string cacheDir, std::string format, bool mipmaps);
+RcppExport SEXP _ropengl_compressTexture(SEXP pathSEXP, SEXP cacheDirSEXP, SEXP formatSEXP, SEXP mipmapsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< std::string >::type cacheDir(cacheDirSEXP);
+    Rcpp::traits::input_parameter< std::string >::type format(formatSEXP);
+    Rcpp::traits::input_parameter< bool >::type mipmaps(mipmapsSEXP);
+    rcpp_result_gen = Rcpp::wrap(compressTexture(path, cacheDir, format, mipmaps));
+    return rcpp_result_gen;
+END_RCPP
+}
+// stopCapture
+List stopCapture();
+RcppExport SEXP _ropengl_stopCapture() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(stopCapture());
+    return rcpp_result_gen;
+END_RCPP
+}
+// startCapture
+void startCapture(std::string target, std::string format, int queue, std::string policy, int workers, int compression);
+RcppExport SEXP _ropengl_startCapture(SEXP targetSEXP, SEXP formatSEXP, SEXP queueSEXP, SEXP policySEXP, SEXP workersSEXP, SEXP compressionSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< std::string >::type format(formatSEXP);
+    Rcpp::traits::input_parameter< int >::type queue(queueSEXP);
+    Rcpp::traits::input_parameter< std::string >::type policy(policySEXP);
+    Rcpp::traits::input_parameter< int >::type workers(workersSEXP);
+    Rcpp::traits::input_parameter< int >::type compression(compressionSEXP);
+    startCapture(target, format, queue, policy, workers, compression);
+    return R_NilValue;
+END_RCPP
+}
+// captureStats
+List captureStats();
+RcppExport SEXP _ropengl_captureStats() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(captureStats());
+    return rcpp_result_gen;
+END_RCPP
+}
+// createCommandBuffer
+SEXP createCommandBuffer();
+RcppExport SEXP _ropengl_createCommandBuffer() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(createCommandBuffer());
+    return rcpp_result_gen;
+END_RCPP
+}
+// cmdReset
+void cmdReset(SEXP cmd);
+RcppExport SEXP _ropengl_cmdReset(SEXP cmdSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    cmdReset(cmd);
+    return R_NilValue;
+END_RCPP
+}
+// cmdSize
+int cmdSize(SEXP cmd);
+RcppExport SEXP _ropengl_cmdSize(SEXP cmdSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    rcpp_result_gen = Rcpp::wrap(cmdSize(cmd));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cmdExecute
+void cmdExecute(SEXP cmd);
+RcppExport SEXP _ropengl_cmdExecute(SEXP cmdSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    cmdExecute(cmd);
+    return R_NilValue;
+END_RCPP
+}
+// cmdActiveTexture
+void cmdActiveTexture(SEXP cmd, unsigned int texture);
+RcppExport SEXP _ropengl_cmdActiveTexture(SEXP cmdSEXP, SEXP textureSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type texture(textureSEXP);
+    cmdActiveTexture(cmd, texture);
+    return R_NilValue;
+END_RCPP
+}
+// cmdBindBuffer
+void cmdBindBuffer(SEXP cmd, unsigned int target, unsigned int buffer);
+RcppExport SEXP _ropengl_cmdBindBuffer(SEXP cmdSEXP, SEXP targetSEXP, SEXP bufferSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type buffer(bufferSEXP);
+    cmdBindBuffer(cmd, target, buffer);
+    return R_NilValue;
+END_RCPP
+}
+// cmdBindTexture
+void cmdBindTexture(SEXP cmd, unsigned int target, unsigned int texture);
+RcppExport SEXP _ropengl_cmdBindTexture(SEXP cmdSEXP, SEXP targetSEXP, SEXP textureSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type texture(textureSEXP);
+    cmdBindTexture(cmd, target, texture);
+    return R_NilValue;
+END_RCPP
+}
+// cmdBindVertexArray
+void cmdBindVertexArray(SEXP cmd, unsigned int array);
+RcppExport SEXP _ropengl_cmdBindVertexArray(SEXP cmdSEXP, SEXP arraySEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type array(arraySEXP);
+    cmdBindVertexArray(cmd, array);
+    return R_NilValue;
+END_RCPP
+}
+// cmdUseProgram
+void cmdUseProgram(SEXP cmd, unsigned int program);
+RcppExport SEXP _ropengl_cmdUseProgram(SEXP cmdSEXP, SEXP programSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type program(programSEXP);
+    cmdUseProgram(cmd, program);
+    return R_NilValue;
+END_RCPP
+}
+// cmdEnable
+void cmdEnable(SEXP cmd, unsigned int cap);
+RcppExport SEXP _ropengl_cmdEnable(SEXP cmdSEXP, SEXP capSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type cap(capSEXP);
+    cmdEnable(cmd, cap);
+    return R_NilValue;
+END_RCPP
+}
+// cmdDisable
+void cmdDisable(SEXP cmd, unsigned int cap);
+RcppExport SEXP _ropengl_cmdDisable(SEXP cmdSEXP, SEXP capSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type cap(capSEXP);
+    cmdDisable(cmd, cap);
+    return R_NilValue;
+END_RCPP
+}
+// cmdBlendFunc
+void cmdBlendFunc(SEXP cmd, unsigned int sfactor, unsigned int dfactor);
+RcppExport SEXP _ropengl_cmdBlendFunc(SEXP cmdSEXP, SEXP sfactorSEXP, SEXP dfactorSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type sfactor(sfactorSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type dfactor(dfactorSEXP);
+    cmdBlendFunc(cmd, sfactor, dfactor);
+    return R_NilValue;
+END_RCPP
+}
+// cmdDepthFunc
+void cmdDepthFunc(SEXP cmd, unsigned int func);
+RcppExport SEXP _ropengl_cmdDepthFunc(SEXP cmdSEXP, SEXP funcSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type func(funcSEXP);
+    cmdDepthFunc(cmd, func);
+    return R_NilValue;
+END_RCPP
+}
+// cmdDepthMask
+void cmdDepthMask(SEXP cmd, unsigned char flag);
+RcppExport SEXP _ropengl_cmdDepthMask(SEXP cmdSEXP, SEXP flagSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned char >::type flag(flagSEXP);
+    cmdDepthMask(cmd, flag);
+    return R_NilValue;
+END_RCPP
+}
+// cmdCullFace
+void cmdCullFace(SEXP cmd, unsigned int mode);
+RcppExport SEXP _ropengl_cmdCullFace(SEXP cmdSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mode(modeSEXP);
+    cmdCullFace(cmd, mode);
+    return R_NilValue;
+END_RCPP
+}
+// cmdViewport
+void cmdViewport(SEXP cmd, int x, int y, int width, int height);
+RcppExport SEXP _ropengl_cmdViewport(SEXP cmdSEXP, SEXP xSEXP, SEXP ySEXP, SEXP widthSEXP, SEXP heightSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< int >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type y(ySEXP);
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type height(heightSEXP);
+    cmdViewport(cmd, x, y, width, height);
+    return R_NilValue;
+END_RCPP
+}
+// cmdClearColor
+void cmdClearColor(SEXP cmd, float red, float green, float blue, float alpha);
+RcppExport SEXP _ropengl_cmdClearColor(SEXP cmdSEXP, SEXP redSEXP, SEXP greenSEXP, SEXP blueSEXP, SEXP alphaSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< float >::type red(redSEXP);
+    Rcpp::traits::input_parameter< float >::type green(greenSEXP);
+    Rcpp::traits::input_parameter< float >::type blue(blueSEXP);
+    Rcpp::traits::input_parameter< float >::type alpha(alphaSEXP);
+    cmdClearColor(cmd, red, green, blue, alpha);
+    return R_NilValue;
+END_RCPP
+}
+// cmdClear
+void cmdClear(SEXP cmd, unsigned int mask);
+RcppExport SEXP _ropengl_cmdClear(SEXP cmdSEXP, SEXP maskSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mask(maskSEXP);
+    cmdClear(cmd, mask);
+    return R_NilValue;
+END_RCPP
+}
+// cmdUniform1f
+void cmdUniform1f(SEXP cmd, int location, float v0);
+RcppExport SEXP _ropengl_cmdUniform1f(SEXP cmdSEXP, SEXP locationSEXP, SEXP v0SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< float >::type v0(v0SEXP);
+    cmdUniform1f(cmd, location, v0);
+    return R_NilValue;
+END_RCPP
+}
+// cmdUniform2f
+void cmdUniform2f(SEXP cmd, int location, float v0, float v1);
+RcppExport SEXP _ropengl_cmdUniform2f(SEXP cmdSEXP, SEXP locationSEXP, SEXP v0SEXP, SEXP v1SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< float >::type v0(v0SEXP);
+    Rcpp::traits::input_parameter< float >::type v1(v1SEXP);
+    cmdUniform2f(cmd, location, v0, v1);
+    return R_NilValue;
+END_RCPP
+}
+// cmdUniform3f
+void cmdUniform3f(SEXP cmd, int location, float v0, float v1, float v2);
+RcppExport SEXP _ropengl_cmdUniform3f(SEXP cmdSEXP, SEXP locationSEXP, SEXP v0SEXP, SEXP v1SEXP, SEXP v2SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< float >::type v0(v0SEXP);
+    Rcpp::traits::input_parameter< float >::type v1(v1SEXP);
+    Rcpp::traits::input_parameter< float >::type v2(v2SEXP);
+    cmdUniform3f(cmd, location, v0, v1, v2);
+    return R_NilValue;
+END_RCPP
+}
+// cmdUniform4f
+void cmdUniform4f(SEXP cmd, int location, float v0, float v1, float v2, float v3);
+RcppExport SEXP _ropengl_cmdUniform4f(SEXP cmdSEXP, SEXP locationSEXP, SEXP v0SEXP, SEXP v1SEXP, SEXP v2SEXP, SEXP v3SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< float >::type v0(v0SEXP);
+    Rcpp::traits::input_parameter< float >::type v1(v1SEXP);
+    Rcpp::traits::input_parameter< float >::type v2(v2SEXP);
+    Rcpp::traits::input_parameter< float >::type v3(v3SEXP);
+    cmdUniform4f(cmd, location, v0, v1, v2, v3);
+    return R_NilValue;
+END_RCPP
+}
+// cmdUniform1i
+void cmdUniform1i(SEXP cmd, int location, int v0);
+RcppExport SEXP _ropengl_cmdUniform1i(SEXP cmdSEXP, SEXP locationSEXP, SEXP v0SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< int >::type v0(v0SEXP);
+    cmdUniform1i(cmd, location, v0);
+    return R_NilValue;
+END_RCPP
+}
+// cmdUniformMatrix4fv
+void cmdUniformMatrix4fv(SEXP cmd, int location, SEXP mat);
+RcppExport SEXP _ropengl_cmdUniformMatrix4fv(SEXP cmdSEXP, SEXP locationSEXP, SEXP matSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type mat(matSEXP);
+    cmdUniformMatrix4fv(cmd, location, mat);
+    return R_NilValue;
+END_RCPP
+}
+// cmdDrawArrays
+void cmdDrawArrays(SEXP cmd, unsigned int mode, int first, int count);
+RcppExport SEXP _ropengl_cmdDrawArrays(SEXP cmdSEXP, SEXP modeSEXP, SEXP firstSEXP, SEXP countSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< int >::type first(firstSEXP);
+    Rcpp::traits::input_parameter< int >::type count(countSEXP);
+    cmdDrawArrays(cmd, mode, first, count);
+    return R_NilValue;
+END_RCPP
+}
+// cmdDrawElements
+void cmdDrawElements(SEXP cmd, unsigned int mode, int count, unsigned int type, int offset);
+RcppExport SEXP _ropengl_cmdDrawElements(SEXP cmdSEXP, SEXP modeSEXP, SEXP countSEXP, SEXP typeSEXP, SEXP offsetSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< int >::type count(countSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< int >::type offset(offsetSEXP);
+    cmdDrawElements(cmd, mode, count, type, offset);
+    return R_NilValue;
+END_RCPP
+}
+// cmdDrawArraysInstanced
+void cmdDrawArraysInstanced(SEXP cmd, unsigned int mode, int first, int count, int instancecount);
+RcppExport SEXP _ropengl_cmdDrawArraysInstanced(SEXP cmdSEXP, SEXP modeSEXP, SEXP firstSEXP, SEXP countSEXP, SEXP instancecountSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< int >::type first(firstSEXP);
+    Rcpp::traits::input_parameter< int >::type count(countSEXP);
+    Rcpp::traits::input_parameter< int >::type instancecount(instancecountSEXP);
+    cmdDrawArraysInstanced(cmd, mode, first, count, instancecount);
+    return R_NilValue;
+END_RCPP
+}
+// cmdDrawElementsInstanced
+void cmdDrawElementsInstanced(SEXP cmd, unsigned int mode, int count, unsigned int type, int instancecount, int offset);
+RcppExport SEXP _ropengl_cmdDrawElementsInstanced(SEXP cmdSEXP, SEXP modeSEXP, SEXP countSEXP, SEXP typeSEXP, SEXP instancecountSEXP, SEXP offsetSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cmd(cmdSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< int >::type count(countSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< int >::type instancecount(instancecountSEXP);
+    Rcpp::traits::input_parameter< int >::type offset(offsetSEXP);
+    cmdDrawElementsInstanced(cmd, mode, count, type, instancecount, offset);
+    return R_NilValue;
+END_RCPP
+}
+// loadCompressedTexture
+unsigned int loadCompressedTexture(std::string path);
+RcppExport SEXP _ropengl_loadCompressedTexture(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(loadCompressedTexture(path));
+    return rcpp_result_gen;
+END_RCPP
+}
 // example
 int example();
 RcppExport SEXP _ropengl_example() {
@@ -185,6 +597,17 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// keyCodes
+IntegerVector keyCodes(CharacterVector names);
+RcppExport SEXP _ropengl_keyCodes(SEXP namesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type names(namesSEXP);
+    rcpp_result_gen = Rcpp::wrap(keyCodes(names));
+    return rcpp_result_gen;
+END_RCPP
+}
 // getKeyByName
 int getKeyByName(std::string name);
 RcppExport SEXP _ropengl_getKeyByName(SEXP nameSEXP) {
@@ -287,15 +710,16 @@ BEGIN_RCPP
 END_RCPP
 }
 // createWindow
-void createWindow(int x, int y, const char* name, bool fullScreen);
-RcppExport SEXP _ropengl_createWindow(SEXP xSEXP, SEXP ySEXP, SEXP nameSEXP, SEXP fullScreenSEXP) {
+void createWindow(int x, int y, const char* name, bool fullScreen, int swapInterval);
+RcppExport SEXP _ropengl_createWindow(SEXP xSEXP, SEXP ySEXP, SEXP nameSEXP, SEXP fullScreenSEXP, SEXP swapIntervalSEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< int >::type x(xSEXP);
     Rcpp::traits::input_parameter< int >::type y(ySEXP);
     Rcpp::traits::input_parameter< const char* >::type name(nameSEXP);
     Rcpp::traits::input_parameter< bool >::type fullScreen(fullScreenSEXP);
-    createWindow(x, y, name, fullScreen);
+    Rcpp::traits::input_parameter< int >::type swapInterval(swapIntervalSEXP);
+    createWindow(x, y, name, fullScreen, swapInterval);
     return R_NilValue;
 END_RCPP
 }
@@ -530,12 +954,12 @@ BEGIN_RCPP
 END_RCPP
 }
 // myGlBufferData
-void myGlBufferData(unsigned int target, std::vector<float> data, unsigned int usage, bool elementArray);
+void myGlBufferData(unsigned int target, SEXP data, unsigned int usage, bool elementArray);
 RcppExport SEXP _ropengl_myGlBufferData(SEXP targetSEXP, SEXP dataSEXP, SEXP usageSEXP, SEXP elementArraySEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< unsigned int >::type target(targetSEXP);
-    Rcpp::traits::input_parameter< std::vector<float> >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type data(dataSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type usage(usageSEXP);
     Rcpp::traits::input_parameter< bool >::type elementArray(elementArraySEXP);
     myGlBufferData(target, data, usage, elementArray);
@@ -543,15 +967,16 @@ BEGIN_RCPP
 END_RCPP
 }
 // myGlBufferSubData
-void myGlBufferSubData(unsigned int target, long long int offset, long long int size, std::vector<float> data);
-RcppExport SEXP _ropengl_myGlBufferSubData(SEXP targetSEXP, SEXP offsetSEXP, SEXP sizeSEXP, SEXP dataSEXP) {
+void myGlBufferSubData(unsigned int target, long long int offset, long long int size, SEXP data, bool elementArray);
+RcppExport SEXP _ropengl_myGlBufferSubData(SEXP targetSEXP, SEXP offsetSEXP, SEXP sizeSEXP, SEXP dataSEXP, SEXP elementArraySEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< unsigned int >::type target(targetSEXP);
     Rcpp::traits::input_parameter< long long int >::type offset(offsetSEXP);
     Rcpp::traits::input_parameter< long long int >::type size(sizeSEXP);
-    Rcpp::traits::input_parameter< std::vector<float> >::type data(dataSEXP);
-    myGlBufferSubData(target, offset, size, data);
+    Rcpp::traits::input_parameter< SEXP >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< bool >::type elementArray(elementArraySEXP);
+    myGlBufferSubData(target, offset, size, data, elementArray);
     return R_NilValue;
 END_RCPP
 }
@@ -633,7 +1058,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // myGlCompressedTexImage2D
-void myGlCompressedTexImage2D(unsigned int target, int level, unsigned int internalformat, int width, int height, int border, int imageSize, std::vector<float> data);
+void myGlCompressedTexImage2D(unsigned int target, int level, unsigned int internalformat, int width, int height, int border, int imageSize, RawVector data);
 RcppExport SEXP _ropengl_myGlCompressedTexImage2D(SEXP targetSEXP, SEXP levelSEXP, SEXP internalformatSEXP, SEXP widthSEXP, SEXP heightSEXP, SEXP borderSEXP, SEXP imageSizeSEXP, SEXP dataSEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -644,13 +1069,13 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type height(heightSEXP);
     Rcpp::traits::input_parameter< int >::type border(borderSEXP);
     Rcpp::traits::input_parameter< int >::type imageSize(imageSizeSEXP);
-    Rcpp::traits::input_parameter< std::vector<float> >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< RawVector >::type data(dataSEXP);
     myGlCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
     return R_NilValue;
 END_RCPP
 }
 // myGlCompressedTexSubImage2D
-void myGlCompressedTexSubImage2D(unsigned int target, int level, int xoffset, int yoffset, int width, int height, unsigned int format, int imageSize, std::vector<float> data);
+void myGlCompressedTexSubImage2D(unsigned int target, int level, int xoffset, int yoffset, int width, int height, unsigned int format, int imageSize, RawVector data);
 RcppExport SEXP _ropengl_myGlCompressedTexSubImage2D(SEXP targetSEXP, SEXP levelSEXP, SEXP xoffsetSEXP, SEXP yoffsetSEXP, SEXP widthSEXP, SEXP heightSEXP, SEXP formatSEXP, SEXP imageSizeSEXP, SEXP dataSEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -662,7 +1087,7 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type height(heightSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type format(formatSEXP);
     Rcpp::traits::input_parameter< int >::type imageSize(imageSizeSEXP);
-    Rcpp::traits::input_parameter< std::vector<float> >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< RawVector >::type data(dataSEXP);
     myGlCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
     return R_NilValue;
 END_RCPP
@@ -870,6 +1295,19 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// myGlDrawArraysInstanced
+void myGlDrawArraysInstanced(unsigned int mode, int first, int count, int instancecount);
+RcppExport SEXP _ropengl_myGlDrawArraysInstanced(SEXP modeSEXP, SEXP firstSEXP, SEXP countSEXP, SEXP instancecountSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< int >::type first(firstSEXP);
+    Rcpp::traits::input_parameter< int >::type count(countSEXP);
+    Rcpp::traits::input_parameter< int >::type instancecount(instancecountSEXP);
+    myGlDrawArraysInstanced(mode, first, count, instancecount);
+    return R_NilValue;
+END_RCPP
+}
 // myGlDrawElements
 void myGlDrawElements(unsigned int mode, int count, unsigned int type);
 RcppExport SEXP _ropengl_myGlDrawElements(SEXP modeSEXP, SEXP countSEXP, SEXP typeSEXP) {
@@ -882,6 +1320,20 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// myGlDrawElementsInstanced
+void myGlDrawElementsInstanced(unsigned int mode, int count, unsigned int type, int instancecount, int offset);
+RcppExport SEXP _ropengl_myGlDrawElementsInstanced(SEXP modeSEXP, SEXP countSEXP, SEXP typeSEXP, SEXP instancecountSEXP, SEXP offsetSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< int >::type count(countSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< int >::type instancecount(instancecountSEXP);
+    Rcpp::traits::input_parameter< int >::type offset(offsetSEXP);
+    myGlDrawElementsInstanced(mode, count, type, instancecount, offset);
+    return R_NilValue;
+END_RCPP
+}
 // myGlEnable
 void myGlEnable(unsigned int cap);
 RcppExport SEXP _ropengl_myGlEnable(SEXP capSEXP) {
@@ -1123,13 +1575,35 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
-// myGlGetTexParameterfv
-std::vector<float> myGlGetTexParameterfv(unsigned int target, unsigned int pname, int n);
-RcppExport SEXP _ropengl_myGlGetTexParameterfv(SEXP targetSEXP, SEXP pnameSEXP, SEXP nSEXP) {
+// myGlGetShaderInfoLog
+std::string myGlGetShaderInfoLog(unsigned int shader);
+RcppExport SEXP _ropengl_myGlGetShaderInfoLog(SEXP shaderSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< unsigned int >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type shader(shaderSEXP);
+    rcpp_result_gen = Rcpp::wrap(myGlGetShaderInfoLog(shader));
+    return rcpp_result_gen;
+END_RCPP
+}
+// myGlGetProgramInfoLog
+std::string myGlGetProgramInfoLog(unsigned int program);
+RcppExport SEXP _ropengl_myGlGetProgramInfoLog(SEXP programSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type program(programSEXP);
+    rcpp_result_gen = Rcpp::wrap(myGlGetProgramInfoLog(program));
+    return rcpp_result_gen;
+END_RCPP
+}
+// myGlGetTexParameterfv
+std::vector<float> myGlGetTexParameterfv(unsigned int target, unsigned int pname, int n);
+RcppExport SEXP _ropengl_myGlGetTexParameterfv(SEXP targetSEXP, SEXP pnameSEXP, SEXP nSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type target(targetSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type pname(pnameSEXP);
     Rcpp::traits::input_parameter< int >::type n(nSEXP);
     rcpp_result_gen = Rcpp::wrap(myGlGetTexParameterfv(target, pname, n));
@@ -1344,7 +1818,7 @@ BEGIN_RCPP
 END_RCPP
 }
 // myGlReadPixels
-std::vector<float> myGlReadPixels(int x, int y, int width, int height, unsigned int format, unsigned int type, int n);
+SEXP myGlReadPixels(int x, int y, int width, int height, unsigned int format, unsigned int type, int n);
 RcppExport SEXP _ropengl_myGlReadPixels(SEXP xSEXP, SEXP ySEXP, SEXP widthSEXP, SEXP heightSEXP, SEXP formatSEXP, SEXP typeSEXP, SEXP nSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
@@ -1902,6 +2376,17 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// myGlVertexAttribDivisor
+void myGlVertexAttribDivisor(unsigned int index, unsigned int divisor);
+RcppExport SEXP _ropengl_myGlVertexAttribDivisor(SEXP indexSEXP, SEXP divisorSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type divisor(divisorSEXP);
+    myGlVertexAttribDivisor(index, divisor);
+    return R_NilValue;
+END_RCPP
+}
 // myGlVertexAttribPointer
 void myGlVertexAttribPointer(unsigned int index, int size, unsigned int type, unsigned char normalized, int stride, int pointer);
 RcppExport SEXP _ropengl_myGlVertexAttribPointer(SEXP indexSEXP, SEXP sizeSEXP, SEXP typeSEXP, SEXP normalizedSEXP, SEXP strideSEXP, SEXP pointerSEXP) {
@@ -1930,8 +2415,880 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// destroyHeadlessContext
+void destroyHeadlessContext();
+RcppExport SEXP _ropengl_destroyHeadlessContext() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    destroyHeadlessContext();
+    return R_NilValue;
+END_RCPP
+}
+// createHeadlessContext
+std::string createHeadlessContext(int width, int height, std::string backend);
+RcppExport SEXP _ropengl_createHeadlessContext(SEXP widthSEXP, SEXP heightSEXP, SEXP backendSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< std::string >::type backend(backendSEXP);
+    rcpp_result_gen = Rcpp::wrap(createHeadlessContext(width, height, backend));
+    return rcpp_result_gen;
+END_RCPP
+}
+// watchProgram
+unsigned int watchProgram(std::string vertex, std::string fragment, std::string geometry, CharacterVector includeDirs, CharacterVector defines);
+RcppExport SEXP _ropengl_watchProgram(SEXP vertexSEXP, SEXP fragmentSEXP, SEXP geometrySEXP, SEXP includeDirsSEXP, SEXP definesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type vertex(vertexSEXP);
+    Rcpp::traits::input_parameter< std::string >::type fragment(fragmentSEXP);
+    Rcpp::traits::input_parameter< std::string >::type geometry(geometrySEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type includeDirs(includeDirsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type defines(definesSEXP);
+    rcpp_result_gen = Rcpp::wrap(watchProgram(vertex, fragment, geometry, includeDirs, defines));
+    return rcpp_result_gen;
+END_RCPP
+}
+// reloadShaders
+int reloadShaders();
+RcppExport SEXP _ropengl_reloadShaders() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(reloadShaders());
+    return rcpp_result_gen;
+END_RCPP
+}
+// drainInputEvents
+DataFrame drainInputEvents();
+RcppExport SEXP _ropengl_drainInputEvents() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(drainInputEvents());
+    return rcpp_result_gen;
+END_RCPP
+}
+// keyboardState
+List keyboardState(IntegerVector codes);
+RcppExport SEXP _ropengl_keyboardState(SEXP codesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type codes(codesSEXP);
+    rcpp_result_gen = Rcpp::wrap(keyboardState(codes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// instanceMatrices
+double instanceMatrices(unsigned int buffer, SEXP positions, SEXP rotations, SEXP scales, double offset, bool allocate, int threads);
+RcppExport SEXP _ropengl_instanceMatrices(SEXP bufferSEXP, SEXP positionsSEXP, SEXP rotationsSEXP, SEXP scalesSEXP, SEXP offsetSEXP, SEXP allocateSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type buffer(bufferSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type positions(positionsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type rotations(rotationsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type scales(scalesSEXP);
+    Rcpp::traits::input_parameter< double >::type offset(offsetSEXP);
+    Rcpp::traits::input_parameter< bool >::type allocate(allocateSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(instanceMatrices(buffer, positions, rotations, scales, offset, allocate, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bindInstanceMatrixAttrib
+void bindInstanceMatrixAttrib(unsigned int buffer, unsigned int location, double offset, unsigned int divisor);
+RcppExport SEXP _ropengl_bindInstanceMatrixAttrib(SEXP bufferSEXP, SEXP locationSEXP, SEXP offsetSEXP, SEXP divisorSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type buffer(bufferSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< double >::type offset(offsetSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type divisor(divisorSEXP);
+    bindInstanceMatrixAttrib(buffer, location, offset, divisor);
+    return R_NilValue;
+END_RCPP
+}
+// mat4
+SEXP mat4(SEXP mat);
+RcppExport SEXP _ropengl_mat4(SEXP matSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type mat(matSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4(mat));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Copy
+SEXP mat4Copy(SEXP m);
+RcppExport SEXP _ropengl_mat4Copy(SEXP mSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Copy(m));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Set
+SEXP mat4Set(SEXP m, SEXP other);
+RcppExport SEXP _ropengl_mat4Set(SEXP mSEXP, SEXP otherSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type other(otherSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Set(m, other));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Identity
+SEXP mat4Identity(SEXP m);
+RcppExport SEXP _ropengl_mat4Identity(SEXP mSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Identity(m));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Ortho
+SEXP mat4Ortho(SEXP m, float left, float right, float bottom, float top, float zNear, float zFar);
+RcppExport SEXP _ropengl_mat4Ortho(SEXP mSEXP, SEXP leftSEXP, SEXP rightSEXP, SEXP bottomSEXP, SEXP topSEXP, SEXP zNearSEXP, SEXP zFarSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< float >::type left(leftSEXP);
+    Rcpp::traits::input_parameter< float >::type right(rightSEXP);
+    Rcpp::traits::input_parameter< float >::type bottom(bottomSEXP);
+    Rcpp::traits::input_parameter< float >::type top(topSEXP);
+    Rcpp::traits::input_parameter< float >::type zNear(zNearSEXP);
+    Rcpp::traits::input_parameter< float >::type zFar(zFarSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Ortho(m, left, right, bottom, top, zNear, zFar));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Perspective
+SEXP mat4Perspective(SEXP m, float fov, float aspect, float zNear, float zFar);
+RcppExport SEXP _ropengl_mat4Perspective(SEXP mSEXP, SEXP fovSEXP, SEXP aspectSEXP, SEXP zNearSEXP, SEXP zFarSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< float >::type fov(fovSEXP);
+    Rcpp::traits::input_parameter< float >::type aspect(aspectSEXP);
+    Rcpp::traits::input_parameter< float >::type zNear(zNearSEXP);
+    Rcpp::traits::input_parameter< float >::type zFar(zFarSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Perspective(m, fov, aspect, zNear, zFar));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4LookAt
+SEXP mat4LookAt(SEXP m, SEXP eye, SEXP center, SEXP up);
+RcppExport SEXP _ropengl_mat4LookAt(SEXP mSEXP, SEXP eyeSEXP, SEXP centerSEXP, SEXP upSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type eye(eyeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type center(centerSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type up(upSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4LookAt(m, eye, center, up));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Translate
+SEXP mat4Translate(SEXP m, SEXP vec);
+RcppExport SEXP _ropengl_mat4Translate(SEXP mSEXP, SEXP vecSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type vec(vecSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Translate(m, vec));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Rotate
+SEXP mat4Rotate(SEXP m, float angle, SEXP axis);
+RcppExport SEXP _ropengl_mat4Rotate(SEXP mSEXP, SEXP angleSEXP, SEXP axisSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< float >::type angle(angleSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type axis(axisSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Rotate(m, angle, axis));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Scale
+SEXP mat4Scale(SEXP m, SEXP vec);
+RcppExport SEXP _ropengl_mat4Scale(SEXP mSEXP, SEXP vecSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type vec(vecSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Scale(m, vec));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Multiply
+SEXP mat4Multiply(SEXP m, SEXP other, bool pre);
+RcppExport SEXP _ropengl_mat4Multiply(SEXP mSEXP, SEXP otherSEXP, SEXP preSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type other(otherSEXP);
+    Rcpp::traits::input_parameter< bool >::type pre(preSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Multiply(m, other, pre));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Inverse
+SEXP mat4Inverse(SEXP m);
+RcppExport SEXP _ropengl_mat4Inverse(SEXP mSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Inverse(m));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4Transpose
+SEXP mat4Transpose(SEXP m);
+RcppExport SEXP _ropengl_mat4Transpose(SEXP mSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4Transpose(m));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mat4ToMatrix
+NumericMatrix mat4ToMatrix(SEXP m);
+RcppExport SEXP _ropengl_mat4ToMatrix(SEXP mSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    rcpp_result_gen = Rcpp::wrap(mat4ToMatrix(m));
+    return rcpp_result_gen;
+END_RCPP
+}
+// uniformMat4
+void uniformMat4(int location, SEXP m);
+RcppExport SEXP _ropengl_uniformMat4(SEXP locationSEXP, SEXP mSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    uniformMat4(location, m);
+    return R_NilValue;
+END_RCPP
+}
+// vec3
+SEXP vec3(SEXP x, double y, double z);
+RcppExport SEXP _ropengl_vec3(SEXP xSEXP, SEXP ySEXP, SEXP zSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< double >::type y(ySEXP);
+    Rcpp::traits::input_parameter< double >::type z(zSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3(x, y, z));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vec3Set
+SEXP vec3Set(SEXP v, SEXP other);
+RcppExport SEXP _ropengl_vec3Set(SEXP vSEXP, SEXP otherSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type other(otherSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3Set(v, other));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vec3Add
+SEXP vec3Add(SEXP v, SEXP other);
+RcppExport SEXP _ropengl_vec3Add(SEXP vSEXP, SEXP otherSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type other(otherSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3Add(v, other));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vec3Scale
+SEXP vec3Scale(SEXP v, double s);
+RcppExport SEXP _ropengl_vec3Scale(SEXP vSEXP, SEXP sSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
+    Rcpp::traits::input_parameter< double >::type s(sSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3Scale(v, s));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vec3Normalize
+SEXP vec3Normalize(SEXP v);
+RcppExport SEXP _ropengl_vec3Normalize(SEXP vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3Normalize(v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vec3Cross
+SEXP vec3Cross(SEXP v, SEXP other);
+RcppExport SEXP _ropengl_vec3Cross(SEXP vSEXP, SEXP otherSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type other(otherSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3Cross(v, other));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vec3Transform
+SEXP vec3Transform(SEXP v, SEXP m, double w);
+RcppExport SEXP _ropengl_vec3Transform(SEXP vSEXP, SEXP mSEXP, SEXP wSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type m(mSEXP);
+    Rcpp::traits::input_parameter< double >::type w(wSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3Transform(v, m, w));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vec3ToVector
+NumericVector vec3ToVector(SEXP v);
+RcppExport SEXP _ropengl_vec3ToVector(SEXP vSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type v(vSEXP);
+    rcpp_result_gen = Rcpp::wrap(vec3ToVector(v));
+    return rcpp_result_gen;
+END_RCPP
+}
+// setSwapInterval
+void setSwapInterval(int interval);
+RcppExport SEXP _ropengl_setSwapInterval(SEXP intervalSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type interval(intervalSEXP);
+    setSwapInterval(interval);
+    return R_NilValue;
+END_RCPP
+}
+// setFrameRate
+void setFrameRate(double fps);
+RcppExport SEXP _ropengl_setFrameRate(SEXP fpsSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type fps(fpsSEXP);
+    setFrameRate(fps);
+    return R_NilValue;
+END_RCPP
+}
+// frameTimeStats
+List frameTimeStats(double deadline, bool reset);
+RcppExport SEXP _ropengl_frameTimeStats(SEXP deadlineSEXP, SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type deadline(deadlineSEXP);
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(frameTimeStats(deadline, reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// buildProgram
+unsigned int buildProgram(std::string vertex, std::string fragment, std::string geometry, CharacterVector defines, std::string cacheDir);
+RcppExport SEXP _ropengl_buildProgram(SEXP vertexSEXP, SEXP fragmentSEXP, SEXP geometrySEXP, SEXP definesSEXP, SEXP cacheDirSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type vertex(vertexSEXP);
+    Rcpp::traits::input_parameter< std::string >::type fragment(fragmentSEXP);
+    Rcpp::traits::input_parameter< std::string >::type geometry(geometrySEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type defines(definesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type cacheDir(cacheDirSEXP);
+    rcpp_result_gen = Rcpp::wrap(buildProgram(vertex, fragment, geometry, defines, cacheDir));
+    return rcpp_result_gen;
+END_RCPP
+}
+// buildPrograms
+DataFrame buildPrograms(CharacterVector vertex, CharacterVector fragment, CharacterVector geometry, SEXP defines, std::string cacheDir);
+RcppExport SEXP _ropengl_buildPrograms(SEXP vertexSEXP, SEXP fragmentSEXP, SEXP geometrySEXP, SEXP definesSEXP, SEXP cacheDirSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type vertex(vertexSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type fragment(fragmentSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type geometry(geometrySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type defines(definesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type cacheDir(cacheDirSEXP);
+    rcpp_result_gen = Rcpp::wrap(buildPrograms(vertex, fragment, geometry, defines, cacheDir));
+    return rcpp_result_gen;
+END_RCPP
+}
+// programCacheStats
+List programCacheStats(bool reset);
+RcppExport SEXP _ropengl_programCacheStats(SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(programCacheStats(reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// setUniform
+bool setUniform(unsigned int program, std::string name, SEXP value);
+RcppExport SEXP _ropengl_setUniform(SEXP programSEXP, SEXP nameSEXP, SEXP valueSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type program(programSEXP);
+    Rcpp::traits::input_parameter< std::string >::type name(nameSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type value(valueSEXP);
+    rcpp_result_gen = Rcpp::wrap(setUniform(program, name, value));
+    return rcpp_result_gen;
+END_RCPP
+}
+// programUniforms
+DataFrame programUniforms(unsigned int program);
+RcppExport SEXP _ropengl_programUniforms(SEXP programSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type program(programSEXP);
+    rcpp_result_gen = Rcpp::wrap(programUniforms(program));
+    return rcpp_result_gen;
+END_RCPP
+}
+// programAttributes
+DataFrame programAttributes(unsigned int program);
+RcppExport SEXP _ropengl_programAttributes(SEXP programSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< unsigned int >::type program(programSEXP);
+    rcpp_result_gen = Rcpp::wrap(programAttributes(program));
+    return rcpp_result_gen;
+END_RCPP
+}
+// readPixelsAsync
+double readPixelsAsync(int x, int y, int width, int height, unsigned int format, unsigned int type);
+RcppExport SEXP _ropengl_readPixelsAsync(SEXP xSEXP, SEXP ySEXP, SEXP widthSEXP, SEXP heightSEXP, SEXP formatSEXP, SEXP typeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type y(ySEXP);
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type format(formatSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type type(typeSEXP);
+    rcpp_result_gen = Rcpp::wrap(readPixelsAsync(x, y, width, height, format, type));
+    return rcpp_result_gen;
+END_RCPP
+}
+// readPixelsReady
+bool readPixelsReady(double ticket);
+RcppExport SEXP _ropengl_readPixelsReady(SEXP ticketSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type ticket(ticketSEXP);
+    rcpp_result_gen = Rcpp::wrap(readPixelsReady(ticket));
+    return rcpp_result_gen;
+END_RCPP
+}
+// readPixelsResult
+SEXP readPixelsResult(double ticket, bool wait);
+RcppExport SEXP _ropengl_readPixelsResult(SEXP ticketSEXP, SEXP waitSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type ticket(ticketSEXP);
+    Rcpp::traits::input_parameter< bool >::type wait(waitSEXP);
+    rcpp_result_gen = Rcpp::wrap(readPixelsResult(ticket, wait));
+    return rcpp_result_gen;
+END_RCPP
+}
+// readNativeRaster
+IntegerMatrix readNativeRaster(int x, int y, int width, int height, bool opaque);
+RcppExport SEXP _ropengl_readNativeRaster(SEXP xSEXP, SEXP ySEXP, SEXP widthSEXP, SEXP heightSEXP, SEXP opaqueSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type y(ySEXP);
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< bool >::type opaque(opaqueSEXP);
+    rcpp_result_gen = Rcpp::wrap(readNativeRaster(x, y, width, height, opaque));
+    return rcpp_result_gen;
+END_RCPP
+}
+// setReadbackBuffers
+void setReadbackBuffers(int n);
+RcppExport SEXP _ropengl_setReadbackBuffers(SEXP nSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    setReadbackBuffers(n);
+    return R_NilValue;
+END_RCPP
+}
+// readbackStats
+List readbackStats(bool reset);
+RcppExport SEXP _ropengl_readbackStats(SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(readbackStats(reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// loadShaderSource
+CharacterVector loadShaderSource(std::string path, CharacterVector includeDirs);
+RcppExport SEXP _ropengl_loadShaderSource(SEXP pathSEXP, SEXP includeDirsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type includeDirs(includeDirsSEXP);
+    rcpp_result_gen = Rcpp::wrap(loadShaderSource(path, includeDirs));
+    return rcpp_result_gen;
+END_RCPP
+}
+// setStateCache
+void setStateCache(bool enabled);
+RcppExport SEXP _ropengl_setStateCache(SEXP enabledSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type enabled(enabledSEXP);
+    setStateCache(enabled);
+    return R_NilValue;
+END_RCPP
+}
+// invalidateStateCache
+void invalidateStateCache();
+RcppExport SEXP _ropengl_invalidateStateCache() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    invalidateStateCache();
+    return R_NilValue;
+END_RCPP
+}
+// stateCacheStats
+List stateCacheStats(bool reset);
+RcppExport SEXP _ropengl_stateCacheStats(SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(stateCacheStats(reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// createStreamBuffer
+SEXP createStreamBuffer(double size, unsigned int target, int alignment, bool orphan);
+RcppExport SEXP _ropengl_createStreamBuffer(SEXP sizeSEXP, SEXP targetSEXP, SEXP alignmentSEXP, SEXP orphanSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< int >::type alignment(alignmentSEXP);
+    Rcpp::traits::input_parameter< bool >::type orphan(orphanSEXP);
+    rcpp_result_gen = Rcpp::wrap(createStreamBuffer(size, target, alignment, orphan));
+    return rcpp_result_gen;
+END_RCPP
+}
+// streamBufferWrite
+double streamBufferWrite(SEXP stream, SEXP data, bool elementArray);
+RcppExport SEXP _ropengl_streamBufferWrite(SEXP streamSEXP, SEXP dataSEXP, SEXP elementArraySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< bool >::type elementArray(elementArraySEXP);
+    rcpp_result_gen = Rcpp::wrap(streamBufferWrite(stream, data, elementArray));
+    return rcpp_result_gen;
+END_RCPP
+}
+// streamBufferFence
+void streamBufferFence(SEXP stream);
+RcppExport SEXP _ropengl_streamBufferFence(SEXP streamSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    streamBufferFence(stream);
+    return R_NilValue;
+END_RCPP
+}
+// streamBufferId
+unsigned int streamBufferId(SEXP stream);
+RcppExport SEXP _ropengl_streamBufferId(SEXP streamSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    rcpp_result_gen = Rcpp::wrap(streamBufferId(stream));
+    return rcpp_result_gen;
+END_RCPP
+}
+// streamBufferStats
+List streamBufferStats(SEXP stream);
+RcppExport SEXP _ropengl_streamBufferStats(SEXP streamSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    rcpp_result_gen = Rcpp::wrap(streamBufferStats(stream));
+    return rcpp_result_gen;
+END_RCPP
+}
+// deleteStreamBuffer
+void deleteStreamBuffer(SEXP stream);
+RcppExport SEXP _ropengl_deleteStreamBuffer(SEXP streamSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    deleteStreamBuffer(stream);
+    return R_NilValue;
+END_RCPP
+}
+// loadTextureArray
+List loadTextureArray(std::vector<std::string> paths, bool mipmaps, int batch);
+RcppExport SEXP _ropengl_loadTextureArray(SEXP pathsSEXP, SEXP mipmapsSEXP, SEXP batchSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type paths(pathsSEXP);
+    Rcpp::traits::input_parameter< bool >::type mipmaps(mipmapsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch(batchSEXP);
+    rcpp_result_gen = Rcpp::wrap(loadTextureArray(paths, mipmaps, batch));
+    return rcpp_result_gen;
+END_RCPP
+}
+// loadTexture
+unsigned int loadTexture(std::string path, bool mipmaps);
+RcppExport SEXP _ropengl_loadTexture(SEXP pathSEXP, SEXP mipmapsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< bool >::type mipmaps(mipmapsSEXP);
+    rcpp_result_gen = Rcpp::wrap(loadTexture(path, mipmaps));
+    return rcpp_result_gen;
+END_RCPP
+}
+// setTextureCacheBudget
+void setTextureCacheBudget(double bytes);
+RcppExport SEXP _ropengl_setTextureCacheBudget(SEXP bytesSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type bytes(bytesSEXP);
+    setTextureCacheBudget(bytes);
+    return R_NilValue;
+END_RCPP
+}
+// clearTextureCache
+void clearTextureCache();
+RcppExport SEXP _ropengl_clearTextureCache() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    clearTextureCache();
+    return R_NilValue;
+END_RCPP
+}
+// textureCacheStats
+List textureCacheStats(bool reset);
+RcppExport SEXP _ropengl_textureCacheStats(SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(textureCacheStats(reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// loadTextureAsync
+SEXP loadTextureAsync(std::string path, bool mipmaps);
+RcppExport SEXP _ropengl_loadTextureAsync(SEXP pathSEXP, SEXP mipmapsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< bool >::type mipmaps(mipmapsSEXP);
+    rcpp_result_gen = Rcpp::wrap(loadTextureAsync(path, mipmaps));
+    return rcpp_result_gen;
+END_RCPP
+}
+// textureReady
+bool textureReady(SEXP handle);
+RcppExport SEXP _ropengl_textureReady(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(textureReady(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// textureId
+unsigned int textureId(SEXP handle);
+RcppExport SEXP _ropengl_textureId(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(textureId(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// waitTexture
+unsigned int waitTexture(SEXP handle);
+RcppExport SEXP _ropengl_waitTexture(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(waitTexture(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// processTextureUploads
+int processTextureUploads(double budget);
+RcppExport SEXP _ropengl_processTextureUploads(SEXP budgetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type budget(budgetSEXP);
+    rcpp_result_gen = Rcpp::wrap(processTextureUploads(budget));
+    return rcpp_result_gen;
+END_RCPP
+}
+// setTextureUploadBudget
+void setTextureUploadBudget(double bytes);
+RcppExport SEXP _ropengl_setTextureUploadBudget(SEXP bytesSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type bytes(bytesSEXP);
+    setTextureUploadBudget(bytes);
+    return R_NilValue;
+END_RCPP
+}
+
+RcppExport SEXP ropengl_fast_glActiveTexture(SEXP);
+RcppExport SEXP ropengl_fast_glBindBuffer(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glBindFramebuffer(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glBindRenderbuffer(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glBindTexture(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glBindVertexArray(SEXP);
+RcppExport SEXP ropengl_fast_glBlendColor(SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glBlendEquation(SEXP);
+RcppExport SEXP ropengl_fast_glBlendFunc(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glClear(SEXP);
+RcppExport SEXP ropengl_fast_glClearColor(SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glColorMask(SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glCullFace(SEXP);
+RcppExport SEXP ropengl_fast_glDepthFunc(SEXP);
+RcppExport SEXP ropengl_fast_glDepthMask(SEXP);
+RcppExport SEXP ropengl_fast_glDisable(SEXP);
+RcppExport SEXP ropengl_fast_glDisableVertexAttribArray(SEXP);
+RcppExport SEXP ropengl_fast_glDrawArrays(SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glDrawElements(SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glEnable(SEXP);
+RcppExport SEXP ropengl_fast_glEnableVertexAttribArray(SEXP);
+RcppExport SEXP ropengl_fast_glFrontFace(SEXP);
+RcppExport SEXP ropengl_fast_glGetError();
+RcppExport SEXP ropengl_fast_glLineWidth(SEXP);
+RcppExport SEXP ropengl_fast_glPolygonOffset(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glScissor(SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glStencilFunc(SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glStencilMask(SEXP);
+RcppExport SEXP ropengl_fast_glStencilOp(SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform1f(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform1i(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform2f(SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform2i(SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform3f(SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform3i(SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform4f(SEXP, SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUniform4i(SEXP, SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glUseProgram(SEXP);
+RcppExport SEXP ropengl_fast_glVertexAttrib1f(SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glVertexAttrib2f(SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glVertexAttrib3f(SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glVertexAttrib4f(SEXP, SEXP, SEXP, SEXP, SEXP);
+RcppExport SEXP ropengl_fast_glViewport(SEXP, SEXP, SEXP, SEXP);
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_ropengl_buildAtlas", (DL_FUNC) &_ropengl_buildAtlas, 4},
+    {"_ropengl_compressTexture", (DL_FUNC) &_ropengl_compressTexture, 4},
+    {"_ropengl_stopCapture", (DL_FUNC) &_ropengl_stopCapture, 0},
+    {"_ropengl_startCapture", (DL_FUNC) &_ropengl_startCapture, 6},
+    {"_ropengl_captureStats", (DL_FUNC) &_ropengl_captureStats, 0},
+    {"_ropengl_createCommandBuffer", (DL_FUNC) &_ropengl_createCommandBuffer, 0},
+    {"_ropengl_cmdReset", (DL_FUNC) &_ropengl_cmdReset, 1},
+    {"_ropengl_cmdSize", (DL_FUNC) &_ropengl_cmdSize, 1},
+    {"_ropengl_cmdExecute", (DL_FUNC) &_ropengl_cmdExecute, 1},
+    {"_ropengl_cmdActiveTexture", (DL_FUNC) &_ropengl_cmdActiveTexture, 2},
+    {"_ropengl_cmdBindBuffer", (DL_FUNC) &_ropengl_cmdBindBuffer, 3},
+    {"_ropengl_cmdBindTexture", (DL_FUNC) &_ropengl_cmdBindTexture, 3},
+    {"_ropengl_cmdBindVertexArray", (DL_FUNC) &_ropengl_cmdBindVertexArray, 2},
+    {"_ropengl_cmdUseProgram", (DL_FUNC) &_ropengl_cmdUseProgram, 2},
+    {"_ropengl_cmdEnable", (DL_FUNC) &_ropengl_cmdEnable, 2},
+    {"_ropengl_cmdDisable", (DL_FUNC) &_ropengl_cmdDisable, 2},
+    {"_ropengl_cmdBlendFunc", (DL_FUNC) &_ropengl_cmdBlendFunc, 3},
+    {"_ropengl_cmdDepthFunc", (DL_FUNC) &_ropengl_cmdDepthFunc, 2},
+    {"_ropengl_cmdDepthMask", (DL_FUNC) &_ropengl_cmdDepthMask, 2},
+    {"_ropengl_cmdCullFace", (DL_FUNC) &_ropengl_cmdCullFace, 2},
+    {"_ropengl_cmdViewport", (DL_FUNC) &_ropengl_cmdViewport, 5},
+    {"_ropengl_cmdClearColor", (DL_FUNC) &_ropengl_cmdClearColor, 5},
+    {"_ropengl_cmdClear", (DL_FUNC) &_ropengl_cmdClear, 2},
+    {"_ropengl_cmdUniform1f", (DL_FUNC) &_ropengl_cmdUniform1f, 3},
+    {"_ropengl_cmdUniform2f", (DL_FUNC) &_ropengl_cmdUniform2f, 4},
+    {"_ropengl_cmdUniform3f", (DL_FUNC) &_ropengl_cmdUniform3f, 5},
+    {"_ropengl_cmdUniform4f", (DL_FUNC) &_ropengl_cmdUniform4f, 6},
+    {"_ropengl_cmdUniform1i", (DL_FUNC) &_ropengl_cmdUniform1i, 3},
+    {"_ropengl_cmdUniformMatrix4fv", (DL_FUNC) &_ropengl_cmdUniformMatrix4fv, 3},
+    {"_ropengl_cmdDrawArrays", (DL_FUNC) &_ropengl_cmdDrawArrays, 4},
+    {"_ropengl_cmdDrawElements", (DL_FUNC) &_ropengl_cmdDrawElements, 5},
+    {"_ropengl_cmdDrawArraysInstanced", (DL_FUNC) &_ropengl_cmdDrawArraysInstanced, 5},
+    {"_ropengl_cmdDrawElementsInstanced", (DL_FUNC) &_ropengl_cmdDrawElementsInstanced, 6},
+    {"_ropengl_loadCompressedTexture", (DL_FUNC) &_ropengl_loadCompressedTexture, 1},
     {"_ropengl_example", (DL_FUNC) &_ropengl_example, 0},
     {"_ropengl_readFile", (DL_FUNC) &_ropengl_readFile, 1},
     {"_ropengl_myGlfwInit", (DL_FUNC) &_ropengl_myGlfwInit, 0},
@@ -1947,6 +3304,7 @@ static const R_CallMethodDef CallEntries[] = {
     {"_ropengl_normalize", (DL_FUNC) &_ropengl_normalize, 1},
     {"_ropengl_cross", (DL_FUNC) &_ropengl_cross, 2},
     {"_ropengl_getKeyId", (DL_FUNC) &_ropengl_getKeyId, 1},
+    {"_ropengl_keyCodes", (DL_FUNC) &_ropengl_keyCodes, 1},
     {"_ropengl_getKeyByName", (DL_FUNC) &_ropengl_getKeyByName, 1},
     {"_ropengl_myGlfwGetKeyName", (DL_FUNC) &_ropengl_myGlfwGetKeyName, 1},
     {"_ropengl_getKeyById", (DL_FUNC) &_ropengl_getKeyById, 1},
@@ -1957,7 +3315,7 @@ static const R_CallMethodDef CallEntries[] = {
     {"_ropengl_setCursorPos", (DL_FUNC) &_ropengl_setCursorPos, 2},
     {"_ropengl_getMouseButtons", (DL_FUNC) &_ropengl_getMouseButtons, 0},
     {"_ropengl_getScrollWheel", (DL_FUNC) &_ropengl_getScrollWheel, 0},
-    {"_ropengl_createWindow", (DL_FUNC) &_ropengl_createWindow, 4},
+    {"_ropengl_createWindow", (DL_FUNC) &_ropengl_createWindow, 5},
     {"_ropengl_focusWindow", (DL_FUNC) &_ropengl_focusWindow, 0},
     {"_ropengl_closeWindow", (DL_FUNC) &_ropengl_closeWindow, 0},
     {"_ropengl_shouldWindowClose", (DL_FUNC) &_ropengl_shouldWindowClose, 0},
@@ -1980,7 +3338,7 @@ static const R_CallMethodDef CallEntries[] = {
     {"_ropengl_myGlBlendFunc", (DL_FUNC) &_ropengl_myGlBlendFunc, 2},
     {"_ropengl_myGlBlendFuncSeparate", (DL_FUNC) &_ropengl_myGlBlendFuncSeparate, 4},
     {"_ropengl_myGlBufferData", (DL_FUNC) &_ropengl_myGlBufferData, 4},
-    {"_ropengl_myGlBufferSubData", (DL_FUNC) &_ropengl_myGlBufferSubData, 4},
+    {"_ropengl_myGlBufferSubData", (DL_FUNC) &_ropengl_myGlBufferSubData, 5},
     {"_ropengl_myGlCheckFramebufferStatus", (DL_FUNC) &_ropengl_myGlCheckFramebufferStatus, 1},
     {"_ropengl_myGlClear", (DL_FUNC) &_ropengl_myGlClear, 1},
     {"_ropengl_myGlClearColor", (DL_FUNC) &_ropengl_myGlClearColor, 4},
@@ -2008,7 +3366,9 @@ static const R_CallMethodDef CallEntries[] = {
     {"_ropengl_myGlDisable", (DL_FUNC) &_ropengl_myGlDisable, 1},
     {"_ropengl_myGlDisableVertexAttribArray", (DL_FUNC) &_ropengl_myGlDisableVertexAttribArray, 1},
     {"_ropengl_myGlDrawArrays", (DL_FUNC) &_ropengl_myGlDrawArrays, 3},
+    {"_ropengl_myGlDrawArraysInstanced", (DL_FUNC) &_ropengl_myGlDrawArraysInstanced, 4},
     {"_ropengl_myGlDrawElements", (DL_FUNC) &_ropengl_myGlDrawElements, 3},
+    {"_ropengl_myGlDrawElementsInstanced", (DL_FUNC) &_ropengl_myGlDrawElementsInstanced, 5},
     {"_ropengl_myGlEnable", (DL_FUNC) &_ropengl_myGlEnable, 1},
     {"_ropengl_myGlEnableVertexAttribArray", (DL_FUNC) &_ropengl_myGlEnableVertexAttribArray, 1},
     {"_ropengl_myGlFinish", (DL_FUNC) &_ropengl_myGlFinish, 0},
@@ -2030,6 +3390,8 @@ static const R_CallMethodDef CallEntries[] = {
     {"_ropengl_myGlGetProgramiv", (DL_FUNC) &_ropengl_myGlGetProgramiv, 3},
     {"_ropengl_myGlGetRenderbufferParameteriv", (DL_FUNC) &_ropengl_myGlGetRenderbufferParameteriv, 3},
     {"_ropengl_myGlGetShaderiv", (DL_FUNC) &_ropengl_myGlGetShaderiv, 3},
+    {"_ropengl_myGlGetShaderInfoLog", (DL_FUNC) &_ropengl_myGlGetShaderInfoLog, 1},
+    {"_ropengl_myGlGetProgramInfoLog", (DL_FUNC) &_ropengl_myGlGetProgramInfoLog, 1},
     {"_ropengl_myGlGetTexParameterfv", (DL_FUNC) &_ropengl_myGlGetTexParameterfv, 3},
     {"_ropengl_myGlGetTexParameteriv", (DL_FUNC) &_ropengl_myGlGetTexParameteriv, 3},
     {"_ropengl_myGlGetUniformfv", (DL_FUNC) &_ropengl_myGlGetUniformfv, 3},
@@ -2095,8 +3457,119 @@ static const R_CallMethodDef CallEntries[] = {
     {"_ropengl_myGlVertexAttrib3fv", (DL_FUNC) &_ropengl_myGlVertexAttrib3fv, 2},
     {"_ropengl_myGlVertexAttrib4f", (DL_FUNC) &_ropengl_myGlVertexAttrib4f, 5},
     {"_ropengl_myGlVertexAttrib4fv", (DL_FUNC) &_ropengl_myGlVertexAttrib4fv, 2},
+    {"_ropengl_myGlVertexAttribDivisor", (DL_FUNC) &_ropengl_myGlVertexAttribDivisor, 2},
     {"_ropengl_myGlVertexAttribPointer", (DL_FUNC) &_ropengl_myGlVertexAttribPointer, 6},
     {"_ropengl_myGlViewport", (DL_FUNC) &_ropengl_myGlViewport, 4},
+    {"_ropengl_destroyHeadlessContext", (DL_FUNC) &_ropengl_destroyHeadlessContext, 0},
+    {"_ropengl_createHeadlessContext", (DL_FUNC) &_ropengl_createHeadlessContext, 3},
+    {"_ropengl_watchProgram", (DL_FUNC) &_ropengl_watchProgram, 5},
+    {"_ropengl_reloadShaders", (DL_FUNC) &_ropengl_reloadShaders, 0},
+    {"_ropengl_drainInputEvents", (DL_FUNC) &_ropengl_drainInputEvents, 0},
+    {"_ropengl_keyboardState", (DL_FUNC) &_ropengl_keyboardState, 1},
+    {"_ropengl_instanceMatrices", (DL_FUNC) &_ropengl_instanceMatrices, 7},
+    {"_ropengl_bindInstanceMatrixAttrib", (DL_FUNC) &_ropengl_bindInstanceMatrixAttrib, 4},
+    {"_ropengl_mat4", (DL_FUNC) &_ropengl_mat4, 1},
+    {"_ropengl_mat4Copy", (DL_FUNC) &_ropengl_mat4Copy, 1},
+    {"_ropengl_mat4Set", (DL_FUNC) &_ropengl_mat4Set, 2},
+    {"_ropengl_mat4Identity", (DL_FUNC) &_ropengl_mat4Identity, 1},
+    {"_ropengl_mat4Ortho", (DL_FUNC) &_ropengl_mat4Ortho, 7},
+    {"_ropengl_mat4Perspective", (DL_FUNC) &_ropengl_mat4Perspective, 5},
+    {"_ropengl_mat4LookAt", (DL_FUNC) &_ropengl_mat4LookAt, 4},
+    {"_ropengl_mat4Translate", (DL_FUNC) &_ropengl_mat4Translate, 2},
+    {"_ropengl_mat4Rotate", (DL_FUNC) &_ropengl_mat4Rotate, 3},
+    {"_ropengl_mat4Scale", (DL_FUNC) &_ropengl_mat4Scale, 2},
+    {"_ropengl_mat4Multiply", (DL_FUNC) &_ropengl_mat4Multiply, 3},
+    {"_ropengl_mat4Inverse", (DL_FUNC) &_ropengl_mat4Inverse, 1},
+    {"_ropengl_mat4Transpose", (DL_FUNC) &_ropengl_mat4Transpose, 1},
+    {"_ropengl_mat4ToMatrix", (DL_FUNC) &_ropengl_mat4ToMatrix, 1},
+    {"_ropengl_uniformMat4", (DL_FUNC) &_ropengl_uniformMat4, 2},
+    {"_ropengl_vec3", (DL_FUNC) &_ropengl_vec3, 3},
+    {"_ropengl_vec3Set", (DL_FUNC) &_ropengl_vec3Set, 2},
+    {"_ropengl_vec3Add", (DL_FUNC) &_ropengl_vec3Add, 2},
+    {"_ropengl_vec3Scale", (DL_FUNC) &_ropengl_vec3Scale, 2},
+    {"_ropengl_vec3Normalize", (DL_FUNC) &_ropengl_vec3Normalize, 1},
+    {"_ropengl_vec3Cross", (DL_FUNC) &_ropengl_vec3Cross, 2},
+    {"_ropengl_vec3Transform", (DL_FUNC) &_ropengl_vec3Transform, 3},
+    {"_ropengl_vec3ToVector", (DL_FUNC) &_ropengl_vec3ToVector, 1},
+    {"_ropengl_setSwapInterval", (DL_FUNC) &_ropengl_setSwapInterval, 1},
+    {"_ropengl_setFrameRate", (DL_FUNC) &_ropengl_setFrameRate, 1},
+    {"_ropengl_frameTimeStats", (DL_FUNC) &_ropengl_frameTimeStats, 2},
+    {"_ropengl_buildProgram", (DL_FUNC) &_ropengl_buildProgram, 5},
+    {"_ropengl_buildPrograms", (DL_FUNC) &_ropengl_buildPrograms, 5},
+    {"_ropengl_programCacheStats", (DL_FUNC) &_ropengl_programCacheStats, 1},
+    {"_ropengl_setUniform", (DL_FUNC) &_ropengl_setUniform, 3},
+    {"_ropengl_programUniforms", (DL_FUNC) &_ropengl_programUniforms, 1},
+    {"_ropengl_programAttributes", (DL_FUNC) &_ropengl_programAttributes, 1},
+    {"_ropengl_readPixelsAsync", (DL_FUNC) &_ropengl_readPixelsAsync, 6},
+    {"_ropengl_readPixelsReady", (DL_FUNC) &_ropengl_readPixelsReady, 1},
+    {"_ropengl_readPixelsResult", (DL_FUNC) &_ropengl_readPixelsResult, 2},
+    {"_ropengl_readNativeRaster", (DL_FUNC) &_ropengl_readNativeRaster, 5},
+    {"_ropengl_setReadbackBuffers", (DL_FUNC) &_ropengl_setReadbackBuffers, 1},
+    {"_ropengl_readbackStats", (DL_FUNC) &_ropengl_readbackStats, 1},
+    {"_ropengl_loadShaderSource", (DL_FUNC) &_ropengl_loadShaderSource, 2},
+    {"_ropengl_setStateCache", (DL_FUNC) &_ropengl_setStateCache, 1},
+    {"_ropengl_invalidateStateCache", (DL_FUNC) &_ropengl_invalidateStateCache, 0},
+    {"_ropengl_stateCacheStats", (DL_FUNC) &_ropengl_stateCacheStats, 1},
+    {"_ropengl_createStreamBuffer", (DL_FUNC) &_ropengl_createStreamBuffer, 4},
+    {"_ropengl_streamBufferWrite", (DL_FUNC) &_ropengl_streamBufferWrite, 3},
+    {"_ropengl_streamBufferFence", (DL_FUNC) &_ropengl_streamBufferFence, 1},
+    {"_ropengl_streamBufferId", (DL_FUNC) &_ropengl_streamBufferId, 1},
+    {"_ropengl_streamBufferStats", (DL_FUNC) &_ropengl_streamBufferStats, 1},
+    {"_ropengl_deleteStreamBuffer", (DL_FUNC) &_ropengl_deleteStreamBuffer, 1},
+    {"_ropengl_loadTextureArray", (DL_FUNC) &_ropengl_loadTextureArray, 3},
+    {"_ropengl_loadTexture", (DL_FUNC) &_ropengl_loadTexture, 2},
+    {"_ropengl_setTextureCacheBudget", (DL_FUNC) &_ropengl_setTextureCacheBudget, 1},
+    {"_ropengl_clearTextureCache", (DL_FUNC) &_ropengl_clearTextureCache, 0},
+    {"_ropengl_textureCacheStats", (DL_FUNC) &_ropengl_textureCacheStats, 1},
+    {"_ropengl_loadTextureAsync", (DL_FUNC) &_ropengl_loadTextureAsync, 2},
+    {"_ropengl_textureReady", (DL_FUNC) &_ropengl_textureReady, 1},
+    {"_ropengl_textureId", (DL_FUNC) &_ropengl_textureId, 1},
+    {"_ropengl_waitTexture", (DL_FUNC) &_ropengl_waitTexture, 1},
+    {"_ropengl_processTextureUploads", (DL_FUNC) &_ropengl_processTextureUploads, 1},
+    {"_ropengl_setTextureUploadBudget", (DL_FUNC) &_ropengl_setTextureUploadBudget, 1},
+    {"ropengl_fast_glActiveTexture", (DL_FUNC) &ropengl_fast_glActiveTexture, 1},
+    {"ropengl_fast_glBindBuffer", (DL_FUNC) &ropengl_fast_glBindBuffer, 2},
+    {"ropengl_fast_glBindFramebuffer", (DL_FUNC) &ropengl_fast_glBindFramebuffer, 2},
+    {"ropengl_fast_glBindRenderbuffer", (DL_FUNC) &ropengl_fast_glBindRenderbuffer, 2},
+    {"ropengl_fast_glBindTexture", (DL_FUNC) &ropengl_fast_glBindTexture, 2},
+    {"ropengl_fast_glBindVertexArray", (DL_FUNC) &ropengl_fast_glBindVertexArray, 1},
+    {"ropengl_fast_glBlendColor", (DL_FUNC) &ropengl_fast_glBlendColor, 4},
+    {"ropengl_fast_glBlendEquation", (DL_FUNC) &ropengl_fast_glBlendEquation, 1},
+    {"ropengl_fast_glBlendFunc", (DL_FUNC) &ropengl_fast_glBlendFunc, 2},
+    {"ropengl_fast_glClear", (DL_FUNC) &ropengl_fast_glClear, 1},
+    {"ropengl_fast_glClearColor", (DL_FUNC) &ropengl_fast_glClearColor, 4},
+    {"ropengl_fast_glColorMask", (DL_FUNC) &ropengl_fast_glColorMask, 4},
+    {"ropengl_fast_glCullFace", (DL_FUNC) &ropengl_fast_glCullFace, 1},
+    {"ropengl_fast_glDepthFunc", (DL_FUNC) &ropengl_fast_glDepthFunc, 1},
+    {"ropengl_fast_glDepthMask", (DL_FUNC) &ropengl_fast_glDepthMask, 1},
+    {"ropengl_fast_glDisable", (DL_FUNC) &ropengl_fast_glDisable, 1},
+    {"ropengl_fast_glDisableVertexAttribArray", (DL_FUNC) &ropengl_fast_glDisableVertexAttribArray, 1},
+    {"ropengl_fast_glDrawArrays", (DL_FUNC) &ropengl_fast_glDrawArrays, 3},
+    {"ropengl_fast_glDrawElements", (DL_FUNC) &ropengl_fast_glDrawElements, 3},
+    {"ropengl_fast_glEnable", (DL_FUNC) &ropengl_fast_glEnable, 1},
+    {"ropengl_fast_glEnableVertexAttribArray", (DL_FUNC) &ropengl_fast_glEnableVertexAttribArray, 1},
+    {"ropengl_fast_glFrontFace", (DL_FUNC) &ropengl_fast_glFrontFace, 1},
+    {"ropengl_fast_glGetError", (DL_FUNC) &ropengl_fast_glGetError, 0},
+    {"ropengl_fast_glLineWidth", (DL_FUNC) &ropengl_fast_glLineWidth, 1},
+    {"ropengl_fast_glPolygonOffset", (DL_FUNC) &ropengl_fast_glPolygonOffset, 2},
+    {"ropengl_fast_glScissor", (DL_FUNC) &ropengl_fast_glScissor, 4},
+    {"ropengl_fast_glStencilFunc", (DL_FUNC) &ropengl_fast_glStencilFunc, 3},
+    {"ropengl_fast_glStencilMask", (DL_FUNC) &ropengl_fast_glStencilMask, 1},
+    {"ropengl_fast_glStencilOp", (DL_FUNC) &ropengl_fast_glStencilOp, 3},
+    {"ropengl_fast_glUniform1f", (DL_FUNC) &ropengl_fast_glUniform1f, 2},
+    {"ropengl_fast_glUniform1i", (DL_FUNC) &ropengl_fast_glUniform1i, 2},
+    {"ropengl_fast_glUniform2f", (DL_FUNC) &ropengl_fast_glUniform2f, 3},
+    {"ropengl_fast_glUniform2i", (DL_FUNC) &ropengl_fast_glUniform2i, 3},
+    {"ropengl_fast_glUniform3f", (DL_FUNC) &ropengl_fast_glUniform3f, 4},
+    {"ropengl_fast_glUniform3i", (DL_FUNC) &ropengl_fast_glUniform3i, 4},
+    {"ropengl_fast_glUniform4f", (DL_FUNC) &ropengl_fast_glUniform4f, 5},
+    {"ropengl_fast_glUniform4i", (DL_FUNC) &ropengl_fast_glUniform4i, 5},
+    {"ropengl_fast_glUseProgram", (DL_FUNC) &ropengl_fast_glUseProgram, 1},
+    {"ropengl_fast_glVertexAttrib1f", (DL_FUNC) &ropengl_fast_glVertexAttrib1f, 2},
+    {"ropengl_fast_glVertexAttrib2f", (DL_FUNC) &ropengl_fast_glVertexAttrib2f, 3},
+    {"ropengl_fast_glVertexAttrib3f", (DL_FUNC) &ropengl_fast_glVertexAttrib3f, 4},
+    {"ropengl_fast_glVertexAttrib4f", (DL_FUNC) &ropengl_fast_glVertexAttrib4f, 5},
+    {"ropengl_fast_glViewport", (DL_FUNC) &ropengl_fast_glViewport, 4},
     {NULL, NULL, 0}
 };
 
@@ -0,0 +1,165 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <vector>
+#include <string.h>
+#include "state.h"
+#include "textures.h"
+using namespace Rcpp;
+
+/*
+ * Texture atlases. The images are decoded on the texture workers (always as RGBA so
+ * every tile has the same layout), shelf packed tallest first into a power of two
+ * square that grows until everything fits, and copied into one buffer. Each tile gets
+ * `padding` texels on every side filled by extending its edge texels, which keeps
+ * bilinear filtering of the base level from bleeding neighbours in. Tiles are not
+ * aligned to mip blocks, so mip level k only stays clean while padding >= 2^k; with
+ * the default padding of 2 neighbours start to blend from about level 2 down.
+ */
+struct AtlasTile {
+  const DecodedImage * image;
+  int x;
+  int y;
+};
+
+static bool byHeight(const AtlasTile * a, const AtlasTile * b) {
+  return a->image->height > b->image->height;
+}
+
+/* Shelf pack into a size x size square, false when the images do not fit */
+static bool packShelves(std::vector<AtlasTile *> & order, int size, int padding) {
+  int x = 0, y = 0, shelf = 0;
+  for (size_t i = 0; i < order.size(); i++) {
+    int w = order[i]->image->width + 2 * padding;
+    int h = order[i]->image->height + 2 * padding;
+    if(x + w > size) {
+      x = 0;
+      y += shelf;
+      shelf = 0;
+    }
+    if(x + w > size || y + h > size) {
+      return false;
+    }
+    order[i]->x = x + padding;
+    order[i]->y = y + padding;
+    x += w;
+    shelf = std::max(shelf, h);
+  }
+  return true;
+}
+
+/* Copy a tile and clamp-extend its border into the padding around it */
+static void blitPadded(unsigned char * atlas, int size, const AtlasTile & tile, int padding) {
+  const DecodedImage & image = *tile.image;
+  for (int row = -padding; row < image.height + padding; row++) {
+    int sy = std::min(std::max(row, 0), image.height - 1);
+    const unsigned char * src = image.pixels + (size_t) sy * image.width * 4;
+    unsigned char * dst = atlas + ((size_t) (tile.y + row) * size + tile.x) * 4;
+    memcpy(dst, src, (size_t) image.width * 4);
+    for (int p = 1; p <= padding; p++) {
+      memcpy(dst - p * 4, src, 4);
+      memcpy(dst + (image.width - 1 + p) * 4, src + (image.width - 1) * 4, 4);
+    }
+  }
+}
+
+//' Pack image files into one texture atlas
+//'
+//' Images are decoded in parallel, packed with `padding` texels of clamped border
+//' around each one and uploaded as a single RGBA texture.
+//' @param paths image files readable by stb_image
+//' @param padding border texels around each image. Mip level k is free of bleeding
+//' only while `padding` is at least 2^k, so with mipmaps raise it or limit the LOD
+//' @param maxSize largest atlas side to try
+//' @param mipmaps generate mipmaps after uploading
+//' @return list with the GL texture name, the atlas size and a data.frame with the
+//' pixel rectangle and u0, v0, u1, v1 texture coordinates of every path
+//' @export
+// [[Rcpp::export]]
+List buildAtlas(std::vector<std::string> paths, int padding = 2, int maxSize = 4096, bool mipmaps = true) {
+  if(paths.empty()) {
+    stop("no images given");
+  }
+  if(padding < 0 || maxSize <= 0) {
+    stop("padding must not be negative and maxSize must be positive");
+  }
+  std::shared_ptr<ImageBatch> batch = decodeImages(paths, 4);
+  waitImages(*batch);
+  std::vector<DecodedImage> & images = batch->images;
+  std::vector<AtlasTile> tiles(images.size());
+  std::vector<AtlasTile *> order;
+  std::string error;
+  double area = 0;
+  for (size_t i = 0; i < images.size(); i++) {
+    tiles[i].image = &images[i];
+    if(images[i].pixels == NULL) {
+      error = images[i].error;
+      continue;
+    }
+    area += (double) (images[i].width + 2 * padding) * (images[i].height + 2 * padding);
+    order.push_back(&tiles[i]);
+  }
+  std::stable_sort(order.begin(), order.end(), byHeight);
+  int size = 1;
+  while((double) size * size < area) {
+    size *= 2;
+  }
+  while(error.empty()) {
+    if(size > maxSize) {
+      error = "images do not fit in a " + std::to_string(maxSize) + " texel atlas";
+    }
+    else if(packShelves(order, size, padding)) {
+      break;
+    }
+    size *= 2;
+  }
+  if(!error.empty()) {
+    freeImages(*batch);
+    stop(error);
+  }
+  std::vector<unsigned char> atlas((size_t) size * size * 4, 0);
+  for (size_t i = 0; i < tiles.size(); i++) {
+    blitPadded(&atlas[0], size, tiles[i], padding);
+  }
+  freeImages(*batch);
+  GLuint texture;
+  GLint bound, buffer;
+  if(!cachedGetIntegerv(GL_TEXTURE_BINDING_2D, &bound)) {
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+  }
+  if(!cachedGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer)) {
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer);
+  }
+  glGenTextures(1, &texture);
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  cachedBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, &atlas[0]);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  if(mipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  }
+  else {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  }
+  cachedBindTexture(GL_TEXTURE_2D, bound);
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+  int n = images.size();
+  IntegerVector x(n), y(n), width(n), height(n);
+  NumericVector u0(n), v0(n), u1(n), v1(n);
+  for (int i = 0; i < n; i++) {
+    x[i] = tiles[i].x;
+    y[i] = tiles[i].y;
+    width[i] = images[i].width;
+    height[i] = images[i].height;
+    u0[i] = (double) tiles[i].x / size;
+    v0[i] = (double) tiles[i].y / size;
+    u1[i] = (double) (tiles[i].x + images[i].width) / size;
+    v1[i] = (double) (tiles[i].y + images[i].height) / size;
+  }
+  DataFrame uv = DataFrame::create(_["path"] = paths, _["x"] = x, _["y"] = y,
+                                   _["width"] = width, _["height"] = height,
+                                   _["u0"] = u0, _["v0"] = v0, _["u1"] = u1, _["v1"] = v1,
+                                   _["stringsAsFactors"] = false);
+  return List::create(_["texture"] = texture, _["size"] = size, _["uv"] = uv);
+}
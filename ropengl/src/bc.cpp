@@ -0,0 +1,280 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "stb_image.h"
+#include "textures.h"
+using namespace Rcpp;
+
+/*
+ * A small BC1 / BC3 (DXT1 / DXT5) encoder for turning ordinary images into DDS files
+ * once, so later runs load them with loadCompressedTexture. Colour endpoints are the
+ * inset bounding box of the block, with the diagonal picked from the sign of the
+ * colour covariance; every texel then takes the nearest palette entry. This is the
+ * usual real-time quality level, a little below offline encoders. Block rows of each
+ * mip level are split across the texture workers.
+ */
+typedef unsigned char u8;
+
+static void fetchBlock(const u8 * rgba, int width, int height, int bx, int by, u8 block[64]) {
+  for (int y = 0; y < 4; y++) {
+    int sy = std::min(by * 4 + y, height - 1);
+    for (int x = 0; x < 4; x++) {
+      int sx = std::min(bx * 4 + x, width - 1);
+      memcpy(block + (y * 4 + x) * 4, rgba + ((size_t) sy * width + sx) * 4, 4);
+    }
+  }
+}
+
+static unsigned short pack565(const int c[3]) {
+  return (unsigned short) ((((c[0] * 31 + 127) / 255) << 11) | (((c[1] * 63 + 127) / 255) << 5) | ((c[2] * 31 + 127) / 255));
+}
+
+static void unpack565(unsigned short v, int c[3]) {
+  int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+  c[0] = (r << 3) | (r >> 2);
+  c[1] = (g << 2) | (g >> 4);
+  c[2] = (b << 3) | (b >> 2);
+}
+
+static void encodeColor(const u8 block[64], u8 out[8]) {
+  int lo[3] = { 255, 255, 255 }, hi[3] = { 0, 0, 0 };
+  for (int i = 0; i < 16; i++) {
+    for (int c = 0; c < 3; c++) {
+      lo[c] = std::min(lo[c], (int) block[i * 4 + c]);
+      hi[c] = std::max(hi[c], (int) block[i * 4 + c]);
+    }
+  }
+  /* Pick the box diagonal that follows the colours: flip red / green against blue */
+  int covRB = 0, covGB = 0;
+  for (int i = 0; i < 16; i++) {
+    int b = block[i * 4 + 2] * 2 - lo[2] - hi[2];
+    covRB += (block[i * 4] * 2 - lo[0] - hi[0]) * b;
+    covGB += (block[i * 4 + 1] * 2 - lo[1] - hi[1]) * b;
+  }
+  if(covRB < 0) {
+    std::swap(lo[0], hi[0]);
+  }
+  if(covGB < 0) {
+    std::swap(lo[1], hi[1]);
+  }
+  for (int c = 0; c < 3; c++) {
+    int inset = (hi[c] - lo[c]) / 16;
+    hi[c] -= inset;
+    lo[c] += inset;
+  }
+  unsigned short c0 = pack565(hi), c1 = pack565(lo);
+  if(c0 < c1) {
+    std::swap(c0, c1);
+  }
+  unsigned int indices = 0;
+  if(c0 != c1) {
+    int palette[4][3];
+    unpack565(c0, palette[0]);
+    unpack565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+    for (int i = 0; i < 16; i++) {
+      int best = 0, bestError = 1 << 30;
+      for (int p = 0; p < 4; p++) {
+        int error = 0;
+        for (int c = 0; c < 3; c++) {
+          int d = block[i * 4 + c] - palette[p][c];
+          error += d * d;
+        }
+        if(error < bestError) {
+          best = p;
+          bestError = error;
+        }
+      }
+      indices |= (unsigned int) best << (i * 2);
+    }
+  }
+  out[0] = c0 & 0xFF;
+  out[1] = c0 >> 8;
+  out[2] = c1 & 0xFF;
+  out[3] = c1 >> 8;
+  memcpy(out + 4, &indices, 4);
+}
+
+static void encodeAlpha(const u8 block[64], u8 out[8]) {
+  int a0 = 0, a1 = 255;
+  for (int i = 0; i < 16; i++) {
+    a0 = std::max(a0, (int) block[i * 4 + 3]);
+    a1 = std::min(a1, (int) block[i * 4 + 3]);
+  }
+  unsigned long long indices = 0;
+  if(a0 != a1) {
+    int palette[8] = { a0, a1 };
+    for (int p = 2; p < 8; p++) {
+      palette[p] = ((8 - p) * a0 + (p - 1) * a1) / 7;
+    }
+    for (int i = 0; i < 16; i++) {
+      int best = 0, bestError = 256;
+      for (int p = 0; p < 8; p++) {
+        int error = abs(block[i * 4 + 3] - palette[p]);
+        if(error < bestError) {
+          best = p;
+          bestError = error;
+        }
+      }
+      indices |= (unsigned long long) best << (i * 3);
+    }
+  }
+  out[0] = a0;
+  out[1] = a1;
+  for (int i = 0; i < 6; i++) {
+    out[2 + i] = (indices >> (i * 8)) & 0xFF;
+  }
+}
+
+static void encodeLevel(const u8 * rgba, int width, int height, bool alpha, u8 * out) {
+  int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+  int blockBytes = alpha ? 16 : 8;
+  textureWorkerParallel(blocksY, [=](size_t begin, size_t end) {
+    u8 block[64];
+    for (size_t by = begin; by < end; by++) {
+      for (int bx = 0; bx < blocksX; bx++) {
+        u8 * dst = out + (by * blocksX + bx) * blockBytes;
+        fetchBlock(rgba, width, height, bx, by, block);
+        if(alpha) {
+          encodeAlpha(block, dst);
+          dst += 8;
+        }
+        encodeColor(block, dst);
+      }
+    }
+  });
+}
+
+/* Box filter to the next mip level, odd edges repeat their last texel */
+static std::vector<u8> halve(const u8 * rgba, int width, int height) {
+  int w = std::max(width / 2, 1), h = std::max(height / 2, 1);
+  std::vector<u8> out((size_t) w * h * 4);
+  for (int y = 0; y < h; y++) {
+    int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+    for (int x = 0; x < w; x++) {
+      int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+      for (int c = 0; c < 4; c++) {
+        int sum = rgba[((size_t) y0 * width + x0) * 4 + c] + rgba[((size_t) y0 * width + x1) * 4 + c] +
+          rgba[((size_t) y1 * width + x0) * 4 + c] + rgba[((size_t) y1 * width + x1) * 4 + c];
+        out[((size_t) y * w + x) * 4 + c] = (sum + 2) / 4;
+      }
+    }
+  }
+  return out;
+}
+
+static void putU32(std::vector<u8> & out, size_t offset, unsigned int v) {
+  memcpy(&out[offset], &v, 4);
+}
+
+static std::vector<u8> ddsHeader(int width, int height, int levels, bool alpha, size_t linearSize) {
+  std::vector<u8> header(128, 0);
+  memcpy(&header[0], "DDS ", 4);
+  putU32(header, 4, 124);
+  putU32(header, 8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000);
+  putU32(header, 12, height);
+  putU32(header, 16, width);
+  putU32(header, 20, linearSize);
+  putU32(header, 28, levels);
+  putU32(header, 76, 32);
+  putU32(header, 80, 0x4);
+  memcpy(&header[84], alpha ? "DXT5" : "DXT1", 4);
+  putU32(header, 108, 0x1000 | (levels > 1 ? 0x8 | 0x400000 : 0));
+  return header;
+}
+
+static std::string cacheFile(const std::string & path, const std::string & cacheDir, const std::string & format) {
+  if(cacheDir.empty()) {
+    return path + "." + format + ".dds";
+  }
+  unsigned long long hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < path.size(); i++) {
+    hash = (hash ^ (u8) path[i]) * 1099511628211ULL;
+  }
+  char name[32];
+  snprintf(name, sizeof name, "%016llx", hash);
+  return cacheDir + "/" + name + "." + format + ".dds";
+}
+
+//' Compress an image to BC1 / BC3 once and load the result
+//'
+//' The image is encoded to a DDS file, with a full mip chain when asked, unless a cached
+//' file newer than the image already exists; either way the DDS is then loaded with
+//' loadCompressedTexture. BC1 stores 4 bits per texel and drops alpha, BC3 keeps alpha
+//' at 8 bits per texel.
+//' @param path image file readable by stb_image
+//' @param cacheDir directory for the DDS files, next to the image when empty
+//' @param format "bc1", "bc3", or "auto" to use BC3 only for images with transparency
+//' @param mipmaps encode mip levels down to 1x1
+//' @return GL texture name
+//' @export
+// [[Rcpp::export]]
+unsigned int compressTexture(std::string path, std::string cacheDir = "", std::string format = "auto", bool mipmaps = true) {
+  if(format != "auto" && format != "bc1" && format != "bc3") {
+    stop("format must be \"auto\", \"bc1\" or \"bc3\"");
+  }
+  double mtime = textureMtime(path);
+  if(mtime < 0) {
+    stop(path + ": file not found");
+  }
+  std::string cached = cacheFile(path, cacheDir, format);
+  if(textureMtime(cached) >= mtime) {
+    return loadCompressedTexture(cached);
+  }
+  if(!GLAD_GL_EXT_texture_compression_s3tc) {
+    stop("BC1 / BC3 textures need GL_EXT_texture_compression_s3tc");
+  }
+  int width, height, chan;
+  u8 * pixels = stbi_load(path.c_str(), &width, &height, &chan, 4);
+  if(pixels == NULL) {
+    stop(path + ": " + stbi_failure_reason());
+  }
+  bool alpha = format == "bc3";
+  if(format == "auto") {
+    for (size_t i = 3; i < (size_t) width * height * 4 && !alpha; i += 4) {
+      alpha = pixels[i] != 255;
+    }
+  }
+  std::vector<u8> level(pixels, pixels + (size_t) width * height * 4);
+  stbi_image_free(pixels);
+  std::vector<u8> body;
+  int w = width, h = height, levels = 0;
+  size_t linearSize = 0;
+  for (;;) {
+    size_t offset = body.size();
+    size_t bytes = (size_t) ((w + 3) / 4) * ((h + 3) / 4) * (alpha ? 16 : 8);
+    body.resize(offset + bytes);
+    encodeLevel(&level[0], w, h, alpha, &body[offset]);
+    if(levels++ == 0) {
+      linearSize = bytes;
+    }
+    if(!mipmaps || (w == 1 && h == 1)) {
+      break;
+    }
+    level = halve(&level[0], w, h);
+    w = std::max(w / 2, 1);
+    h = std::max(h / 2, 1);
+  }
+  std::vector<u8> header = ddsHeader(width, height, levels, alpha, linearSize);
+  std::string temporary = cached + ".tmp";
+  FILE * out = fopen(temporary.c_str(), "wb");
+  if(out == NULL) {
+    stop(temporary + ": could not be written");
+  }
+  bool written = fwrite(&header[0], 1, header.size(), out) == header.size() &&
+    fwrite(&body[0], 1, body.size(), out) == body.size();
+  written = fclose(out) == 0 && written;
+  remove(cached.c_str());
+  if(!written || rename(temporary.c_str(), cached.c_str()) != 0) {
+    remove(temporary.c_str());
+    stop(cached + ": could not be written");
+  }
+  return loadCompressedTexture(cached);
+}
@@ -0,0 +1,405 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+#ifndef _WIN32
+#include <signal.h>
+#include <pthread.h>
+#endif
+#include "capture.h"
+#include "headless.h"
+#include "readback.h"
+#include "state.h"
+using namespace Rcpp;
+
+/*
+ * Animation capture. While a capture runs, flip() starts an asynchronous read of the
+ * finished back buffer (readback.cpp) and hands reads that have completed to a bounded
+ * queue, so the render loop does not wait for the GPU copy. Worker threads empty the
+ * queue: either encoding numbered PNG files, or writing raw RGBA frames, top row first,
+ * to the stdin of a command such as ffmpeg. A pipe has a single writer so frames stay
+ * in order. When the queue is full the frame is dropped or the render loop waits,
+ * whichever the capture asked for.
+ */
+struct CaptureFrame {
+  int index;
+  int width;
+  int height;
+  std::vector<unsigned char> pixels;
+};
+
+static struct {
+  bool active;
+  bool pipe;
+  bool dropWhenFull;
+  std::string target;
+  FILE * process;
+  size_t capacity;
+  int level;
+  int nextIndex;
+  bool stopping;
+  std::string error;
+  std::deque<unsigned long long> reads;
+  std::deque<CaptureFrame> queue;
+  std::vector<std::thread> workers;
+} capture;
+
+static std::mutex captureMutex;
+static std::condition_variable frameQueued;
+static std::condition_variable frameTaken;
+
+static struct {
+  double captured;
+  double dropped;
+  double written;
+  double bytes;
+  double blockedSeconds;
+  double encodeSeconds;
+  double started;
+} captureCounts;
+
+static double seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void putU32(unsigned char * out, unsigned int v) {
+  out[0] = v >> 24;
+  out[1] = (v >> 16) & 0xFF;
+  out[2] = (v >> 8) & 0xFF;
+  out[3] = v & 0xFF;
+}
+
+static bool writeChunk(FILE * out, const char * type, const unsigned char * data, size_t length) {
+  unsigned char head[8];
+  putU32(head, length);
+  memcpy(head + 4, type, 4);
+  uLong crc = crc32(0, (const Bytef *) type, 4);
+  if(length > 0) {
+    crc = crc32(crc, data, length);
+  }
+  unsigned char tail[4];
+  putU32(tail, crc);
+  return fwrite(head, 1, 8, out) == 8 && (length == 0 || fwrite(data, 1, length, out) == length) && fwrite(tail, 1, 4, out) == 4;
+}
+
+/* RGBA PNG with the "up" filter on every row, rows flipped to top first */
+static std::string writePng(const std::string & path, const CaptureFrame & frame, int level) {
+  size_t stride = (size_t) frame.width * 4;
+  std::vector<unsigned char> filtered((stride + 1) * frame.height);
+  for (int y = 0; y < frame.height; y++) {
+    const unsigned char * row = &frame.pixels[(frame.height - 1 - y) * stride];
+    unsigned char * dst = &filtered[y * (stride + 1)];
+    dst[0] = y == 0 ? 0 : 2;
+    if(y == 0) {
+      memcpy(dst + 1, row, stride);
+      continue;
+    }
+    const unsigned char * above = row + stride;
+    for (size_t i = 0; i < stride; i++) {
+      dst[1 + i] = row[i] - above[i];
+    }
+  }
+  uLongf length = compressBound(filtered.size());
+  std::vector<unsigned char> compressed(length);
+  if(compress2(&compressed[0], &length, &filtered[0], filtered.size(), level) != Z_OK) {
+    return path + ": compression failed";
+  }
+  unsigned char header[13];
+  putU32(header, frame.width);
+  putU32(header + 4, frame.height);
+  header[8] = 8;
+  header[9] = 6;
+  header[10] = header[11] = header[12] = 0;
+  FILE * out = fopen(path.c_str(), "wb");
+  if(out == NULL) {
+    return path + ": could not be written";
+  }
+  bool written = fwrite("\x89PNG\r\n\x1a\n", 1, 8, out) == 8 &&
+    writeChunk(out, "IHDR", header, sizeof header) &&
+    writeChunk(out, "IDAT", &compressed[0], length) &&
+    writeChunk(out, "IEND", NULL, 0);
+  written = fclose(out) == 0 && written;
+  return written ? "" : path + ": could not be written";
+}
+
+static std::string writeRaw(FILE * process, const CaptureFrame & frame) {
+  size_t stride = (size_t) frame.width * 4;
+  for (int y = frame.height - 1; y >= 0; y--) {
+    if(fwrite(&frame.pixels[y * stride], 1, stride, process) != stride) {
+      return "capture command stopped reading frames";
+    }
+  }
+  return "";
+}
+
+/*
+ * The file name pattern goes to snprintf with an int, so it may hold exactly one %d,
+ * with at most two width digits to stay inside the path buffer, and otherwise only %%.
+ */
+static bool validPattern(const std::string & target) {
+  int conversions = 0;
+  for (size_t i = 0; i < target.size(); i++) {
+    if(target[i] != '%') {
+      continue;
+    }
+    if(i + 1 < target.size() && target[i + 1] == '%') {
+      i++;
+      continue;
+    }
+    size_t digits = 0;
+    while(i + 1 + digits < target.size() && target[i + 1 + digits] >= '0' && target[i + 1 + digits] <= '9') {
+      digits++;
+    }
+    i += 1 + digits;
+    if(digits > 2 || i >= target.size() || target[i] != 'd') {
+      return false;
+    }
+    conversions++;
+  }
+  return conversions == 1;
+}
+
+static void captureWorker() {
+#ifndef _WIN32
+  /* A command that exits early makes writes fail with EPIPE instead of killing R */
+  sigset_t pipeSignal;
+  sigemptyset(&pipeSignal);
+  sigaddset(&pipeSignal, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipeSignal, NULL);
+#endif
+  for (;;) {
+    CaptureFrame frame;
+    {
+      std::unique_lock<std::mutex> lock(captureMutex);
+      frameQueued.wait(lock, [] { return !capture.queue.empty() || capture.stopping; });
+      if(capture.queue.empty()) {
+        return;
+      }
+      frame.pixels.swap(capture.queue.front().pixels);
+      frame.index = capture.queue.front().index;
+      frame.width = capture.queue.front().width;
+      frame.height = capture.queue.front().height;
+      capture.queue.pop_front();
+    }
+    frameTaken.notify_one();
+    double start = seconds();
+    std::string error;
+    if(capture.pipe) {
+      error = writeRaw(capture.process, frame);
+    }
+    else {
+      std::vector<char> path(capture.target.size() + 32);
+      snprintf(&path[0], path.size(), capture.target.c_str(), frame.index);
+      error = writePng(&path[0], frame, capture.level);
+    }
+    std::lock_guard<std::mutex> lock(captureMutex);
+    captureCounts.encodeSeconds += seconds() - start;
+    if(error.empty()) {
+      captureCounts.written++;
+      captureCounts.bytes += frame.pixels.size();
+    }
+    else if(capture.error.empty()) {
+      capture.error = error;
+    }
+  }
+}
+
+static void enqueueFrame(CaptureFrame & frame, bool block) {
+  std::unique_lock<std::mutex> lock(captureMutex);
+  if(capture.queue.size() >= capture.capacity) {
+    if(!block) {
+      captureCounts.dropped++;
+      return;
+    }
+    double start = seconds();
+    frameTaken.wait(lock, [] { return capture.queue.size() < capture.capacity; });
+    captureCounts.blockedSeconds += seconds() - start;
+  }
+  frame.index = capture.nextIndex++;
+  capture.queue.push_back(CaptureFrame());
+  std::swap(capture.queue.back(), frame);
+  captureCounts.captured++;
+  lock.unlock();
+  frameQueued.notify_one();
+}
+
+/* The counters as an R list, with captureMutex held */
+static List countsList() {
+  return List::create(_["captured"] = captureCounts.captured,
+                      _["dropped"] = captureCounts.dropped,
+                      _["written"] = captureCounts.written,
+                      _["bytes"] = captureCounts.bytes,
+                      _["blockedSeconds"] = captureCounts.blockedSeconds,
+                      _["encodeSeconds"] = captureCounts.encodeSeconds,
+                      _["fps"] = captureCounts.written / (seconds() - captureCounts.started));
+}
+
+/* Join the workers and close the command, leaving queued frames to them first */
+static int finishCapture() {
+  {
+    std::lock_guard<std::mutex> lock(captureMutex);
+    capture.stopping = true;
+  }
+  frameQueued.notify_all();
+  for (size_t i = 0; i < capture.workers.size(); i++) {
+    capture.workers[i].join();
+  }
+  capture.workers.clear();
+  int status = 0;
+  if(capture.process != NULL) {
+#ifdef _WIN32
+    status = _pclose(capture.process);
+#else
+    status = pclose(capture.process);
+#endif
+    capture.process = NULL;
+  }
+  capture.active = false;
+  return status;
+}
+
+/* Stops a running capture when the package library is unloaded */
+static struct CaptureShutdown {
+  ~CaptureShutdown() {
+    if(capture.active) {
+      finishCapture();
+    }
+  }
+} captureShutdown;
+
+/* Move finished reads to the queue; with `all` wait for every read still in flight */
+static void collectReads(bool all) {
+  while(!capture.reads.empty() && (all || capture.reads.size() > 2 || readbackReady(capture.reads.front()))) {
+    unsigned long long ticket = capture.reads.front();
+    capture.reads.pop_front();
+    CaptureFrame frame;
+    GLenum format, type;
+    const unsigned char * pixels = readbackMap(ticket, &frame.width, &frame.height, &format, &type);
+    frame.pixels.assign(pixels, pixels + (size_t) frame.width * frame.height * 4);
+    readbackRelease(ticket);
+    enqueueFrame(frame, all || !capture.dropWhenFull);
+  }
+}
+
+void captureFrame() {
+  if(!capture.active) {
+    return;
+  }
+  collectReads(false);
+  int width, height;
+  defaultFramebufferSize(&width, &height);
+  if(width <= 0 || height <= 0) {
+    return;
+  }
+  GLint readFramebuffer;
+  if(!cachedGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer)) {
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+  }
+  cachedBindFramebuffer(GL_READ_FRAMEBUFFER, headlessFramebuffer());
+  capture.reads.push_back(readbackStart(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE));
+  cachedBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+}
+
+//' Stop capturing frames
+//'
+//' Waits for the frames still queued to be written and closes the command's input.
+//' @return list as returned by captureStats
+//' @export
+// [[Rcpp::export]]
+List stopCapture() {
+  if(!capture.active) {
+    stop("no capture is running");
+  }
+  collectReads(true);
+  int status = finishCapture();
+  std::string error = capture.error;
+  if(error.empty() && status != 0) {
+    error = "capture command exited with status " + std::to_string(status);
+  }
+  List out = countsList();
+  if(!error.empty()) {
+    warning(error);
+  }
+  return out;
+}
+
+//' Capture every flipped frame to files or a command
+//'
+//' From now on each flip() reads the finished frame back asynchronously and queues it
+//' for background writing. PNG files are named by passing the frame number to sprintf
+//' with `target`. With format "pipe", `target` is a command whose standard input gets
+//' raw 8-bit RGBA frames, top row first, for example
+//' "ffmpeg -y -f rawvideo -pix_fmt rgba -s 1280x720 -r 60 -i - out.mp4".
+//' @param target file name pattern such as "frames/frame%05d.png", or a command. The
+//' pattern takes one %d with an optional width below 100; write a literal % as %%
+//' @param format "png" or "pipe"
+//' @param queue number of frames that may wait to be written
+//' @param policy "block" to make flip() wait for room in the queue, "drop" to skip the
+//' frame instead
+//' @param workers PNG encoding threads; a pipe always has one writer
+//' @param compression zlib level for PNG files, 0 to 9
+//' @export
+// [[Rcpp::export]]
+void startCapture(std::string target, std::string format = "png", int queue = 8, std::string policy = "block", int workers = 2, int compression = 1) {
+  if(capture.active) {
+    stop("a capture is already running");
+  }
+  if(format != "png" && format != "pipe") {
+    stop("format must be \"png\" or \"pipe\"");
+  }
+  if(policy != "block" && policy != "drop") {
+    stop("policy must be \"block\" or \"drop\"");
+  }
+  if(queue < 1 || workers < 1 || compression < 0 || compression > 9) {
+    stop("queue and workers must be positive and compression between 0 and 9");
+  }
+  if(format == "png" && !validPattern(target)) {
+    stop("target needs exactly one %d style conversion for the frame number, any other % written as %%");
+  }
+  capture.process = NULL;
+  if(format == "pipe") {
+#ifdef _WIN32
+    capture.process = _popen(target.c_str(), "wb");
+#else
+    capture.process = popen(target.c_str(), "w");
+#endif
+    if(capture.process == NULL) {
+      stop(target + ": could not be started");
+    }
+    workers = 1;
+  }
+  capture.pipe = format == "pipe";
+  capture.dropWhenFull = policy == "drop";
+  capture.target = target;
+  capture.capacity = queue;
+  capture.level = compression;
+  capture.nextIndex = 0;
+  capture.stopping = false;
+  capture.error.clear();
+  capture.reads.clear();
+  capture.queue.clear();
+  memset(&captureCounts, 0, sizeof captureCounts);
+  captureCounts.started = seconds();
+  for (int i = 0; i < workers; i++) {
+    capture.workers.push_back(std::thread(captureWorker));
+  }
+  capture.active = true;
+}
+
+//' Frame capture statistics
+//' @return list with frames captured into the queue, dropped because it was full and
+//' written, bytes of pixels written, seconds flip() spent waiting for room and workers
+//' spent encoding, and frames written per second since the capture started
+//' @export
+// [[Rcpp::export]]
+List captureStats() {
+  std::lock_guard<std::mutex> lock(captureMutex);
+  return countsList();
+}
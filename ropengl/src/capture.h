@@ -0,0 +1,7 @@
+#ifndef ROPENGL_CAPTURE_H
+#define ROPENGL_CAPTURE_H
+
+/* Frame capture, see capture.cpp. flip() calls captureFrame before swapping */
+void captureFrame();
+
+#endif
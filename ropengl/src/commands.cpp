@@ -0,0 +1,478 @@
+#include "ropengl.h"
+#include "state.h"
+#include "programs.h"
+#include <vector>
+#include <map>
+#include <string.h>
+using namespace Rcpp;
+
+/*
+ * Command buffers: GL calls are recorded once into a flat opcode stream and replayed
+ * with a single .Call per frame. Every command is a header word (opcode | length << 16)
+ * followed by its arguments as 32-bit words; floats are stored bit-for-bit.
+ */
+enum CommandOp {
+  CMD_ACTIVE_TEXTURE,
+  CMD_BIND_BUFFER,
+  CMD_BIND_TEXTURE,
+  CMD_BIND_VERTEX_ARRAY,
+  CMD_USE_PROGRAM,
+  CMD_ENABLE,
+  CMD_DISABLE,
+  CMD_BLEND_FUNC,
+  CMD_DEPTH_FUNC,
+  CMD_DEPTH_MASK,
+  CMD_CULL_FACE,
+  CMD_VIEWPORT,
+  CMD_CLEAR_COLOR,
+  CMD_CLEAR,
+  CMD_UNIFORM_1F,
+  CMD_UNIFORM_2F,
+  CMD_UNIFORM_3F,
+  CMD_UNIFORM_4F,
+  CMD_UNIFORM_1I,
+  CMD_UNIFORM_MATRIX_4FV,
+  CMD_DRAW_ARRAYS,
+  CMD_DRAW_ELEMENTS,
+  CMD_DRAW_ARRAYS_INSTANCED,
+  CMD_DRAW_ELEMENTS_INSTANCED
+};
+
+struct CommandBuffer {
+  std::vector<GLuint> words;
+  int commands;
+  bool optimized;
+};
+
+static GLuint floatBits(float f) {
+  GLuint u;
+  memcpy(&u, &f, 4);
+  return u;
+}
+
+static float bitsFloat(GLuint u) {
+  float f;
+  memcpy(&f, &u, 4);
+  return f;
+}
+
+static CommandBuffer * commandPtr(SEXP cmd) {
+  CommandBuffer * cb = XPtr<CommandBuffer>(cmd).get();
+  if(cb == NULL) {
+    stop("invalid command buffer");
+  }
+  return cb;
+}
+
+static void record(SEXP cmd, GLuint op, const GLuint * args, GLuint n) {
+  CommandBuffer * cb = commandPtr(cmd);
+  cb->words.push_back(op | (n << 16));
+  cb->words.insert(cb->words.end(), args, args + n);
+  cb->commands++;
+  cb->optimized = false;
+}
+
+static void record(SEXP cmd, GLuint op, GLuint a) {
+  record(cmd, op, &a, 1);
+}
+
+static void record(SEXP cmd, GLuint op, GLuint a, GLuint b) {
+  GLuint args[] = {a, b};
+  record(cmd, op, args, 2);
+}
+
+/* vertices per independent primitive, or 0 for modes whose draws cannot be joined */
+static GLuint verticesPerPrimitive(GLuint mode) {
+  switch(mode) {
+  case GL_POINTS:
+    return 1;
+  case GL_LINES:
+    return 2;
+  case GL_TRIANGLES:
+    return 3;
+  default:
+    return 0;
+  }
+}
+
+/*
+ * Drops state commands that re-set the value already set earlier in the stream and
+ * folds back-to-back glDrawArrays calls over adjacent ranges into one draw. A draw
+ * is only extended when it holds whole primitives, otherwise its leftover vertices
+ * would pair up with the next draw's.
+ */
+static void optimize(CommandBuffer * cb) {
+  std::vector<GLuint> out;
+  std::map<unsigned long long, std::vector<GLuint> > last;
+  GLuint activeTexture = GL_TEXTURE0;
+  GLuint program = 0;
+  size_t lastDraw = (size_t) -1;
+  int commands = 0;
+  out.reserve(cb->words.size());
+  for (size_t i = 0; i < cb->words.size(); ) {
+    GLuint op = cb->words[i] & 0xFFFF;
+    GLuint n = cb->words[i] >> 16;
+    const GLuint * a = &cb->words[i + 1];
+    i += n + 1;
+    unsigned long long key = 0;
+    bool stateful = true;
+    switch(op) {
+    case CMD_ACTIVE_TEXTURE:
+      activeTexture = a[0];
+      key = op;
+      break;
+    case CMD_BIND_BUFFER:
+      key = ((unsigned long long) a[0] << 8) | op;
+      break;
+    case CMD_BIND_TEXTURE:
+      key = ((unsigned long long) activeTexture << 40) | ((unsigned long long) a[0] << 8) | op;
+      break;
+    case CMD_USE_PROGRAM:
+      program = a[0];
+      key = op;
+      break;
+    case CMD_ENABLE:
+    case CMD_DISABLE:
+      key = ((unsigned long long) a[0] << 8) | CMD_ENABLE;
+      break;
+    case CMD_UNIFORM_1F:
+    case CMD_UNIFORM_2F:
+    case CMD_UNIFORM_3F:
+    case CMD_UNIFORM_4F:
+    case CMD_UNIFORM_1I:
+    case CMD_UNIFORM_MATRIX_4FV:
+      key = ((unsigned long long) program << 40) | ((unsigned long long) a[0] << 8) | op;
+      break;
+    case CMD_BIND_VERTEX_ARRAY:
+      /* element array bindings are VAO state */
+      last.erase(((unsigned long long) GL_ELEMENT_ARRAY_BUFFER << 8) | CMD_BIND_BUFFER);
+      key = op;
+      break;
+    case CMD_CLEAR:
+    case CMD_DRAW_ARRAYS:
+    case CMD_DRAW_ELEMENTS:
+    case CMD_DRAW_ARRAYS_INSTANCED:
+    case CMD_DRAW_ELEMENTS_INSTANCED:
+      stateful = false;
+      break;
+    default:
+      key = op;
+    }
+    if(stateful) {
+      std::vector<GLuint> value(&cb->words[i - n - 1], &cb->words[i]);
+      std::map<unsigned long long, std::vector<GLuint> >::iterator it = last.find(key);
+      if(it != last.end() && it->second == value) {
+        continue;
+      }
+      last[key] = value;
+      lastDraw = (size_t) -1;
+    }
+    else if(op == CMD_DRAW_ARRAYS && lastDraw != (size_t) -1) {
+      GLuint * prev = &out[lastDraw + 1];
+      GLuint vertices = verticesPerPrimitive(a[0]);
+      if(prev[0] == a[0] && vertices != 0 && prev[2] % vertices == 0 && prev[1] + prev[2] == a[1]) {
+        prev[2] += a[2];
+        continue;
+      }
+    }
+    if(op == CMD_DRAW_ARRAYS) {
+      lastDraw = out.size();
+    }
+    else if(!stateful) {
+      lastDraw = (size_t) -1;
+    }
+    out.insert(out.end(), &cb->words[i - n - 1], &cb->words[i]);
+    commands++;
+  }
+  cb->words.swap(out);
+  cb->commands = commands;
+  cb->optimized = true;
+}
+
+//' Create an empty command buffer
+//' @return external pointer to record commands into with the cmd* functions
+//' @export
+// [[Rcpp::export]]
+SEXP createCommandBuffer() {
+  CommandBuffer * cb = new CommandBuffer();
+  cb->commands = 0;
+  cb->optimized = true;
+  return XPtr<CommandBuffer>(cb, true);
+}
+
+//' Clear all recorded commands
+//' @param cmd command buffer
+//' @export
+// [[Rcpp::export]]
+void cmdReset(SEXP cmd) {
+  CommandBuffer * cb = commandPtr(cmd);
+  cb->words.clear();
+  cb->commands = 0;
+  cb->optimized = true;
+}
+
+//' Number of commands in a command buffer
+//' @param cmd command buffer
+//' @export
+// [[Rcpp::export]]
+int cmdSize(SEXP cmd) {
+  return commandPtr(cmd)->commands;
+}
+
+//' Replay a command buffer
+//'
+//' The first execution after recording runs the merge pass, later ones replay the
+//' optimized stream directly.
+//' @param cmd command buffer
+//' @export
+// [[Rcpp::export]]
+void cmdExecute(SEXP cmd) {
+  CommandBuffer * cb = commandPtr(cmd);
+  if(!cb->optimized) {
+    optimize(cb);
+  }
+  const GLuint * w = cb->words.empty() ? NULL : &cb->words[0];
+  const GLuint * end = w + cb->words.size();
+  while(w < end) {
+    GLuint op = w[0] & 0xFFFF;
+    const GLuint * a = w + 1;
+    w += (w[0] >> 16) + 1;
+    switch(op) {
+    case CMD_ACTIVE_TEXTURE:
+      cachedActiveTexture(a[0]);
+      break;
+    case CMD_BIND_BUFFER:
+      cachedBindBuffer(a[0], a[1]);
+      break;
+    case CMD_BIND_TEXTURE:
+      cachedBindTexture(a[0], a[1]);
+      break;
+    case CMD_BIND_VERTEX_ARRAY:
+      cachedBindVertexArray(a[0]);
+      break;
+    case CMD_USE_PROGRAM:
+      cachedUseProgram(a[0]);
+      break;
+    case CMD_ENABLE:
+      cachedEnable(a[0]);
+      break;
+    case CMD_DISABLE:
+      cachedDisable(a[0]);
+      break;
+    case CMD_BLEND_FUNC:
+      cachedBlendFunc(a[0], a[1]);
+      break;
+    case CMD_DEPTH_FUNC:
+      cachedDepthFunc(a[0]);
+      break;
+    case CMD_DEPTH_MASK:
+      cachedDepthMask(a[0]);
+      break;
+    case CMD_CULL_FACE:
+      cachedCullFace(a[0]);
+      break;
+    case CMD_VIEWPORT:
+      glViewport(a[0], a[1], a[2], a[3]);
+      break;
+    case CMD_CLEAR_COLOR:
+      glClearColor(bitsFloat(a[0]), bitsFloat(a[1]), bitsFloat(a[2]), bitsFloat(a[3]));
+      break;
+    case CMD_CLEAR:
+      glClear(a[0]);
+      break;
+    case CMD_UNIFORM_1F:
+      uniformsTouched();
+      glUniform1f(a[0], bitsFloat(a[1]));
+      break;
+    case CMD_UNIFORM_2F:
+      uniformsTouched();
+      glUniform2f(a[0], bitsFloat(a[1]), bitsFloat(a[2]));
+      break;
+    case CMD_UNIFORM_3F:
+      uniformsTouched();
+      glUniform3f(a[0], bitsFloat(a[1]), bitsFloat(a[2]), bitsFloat(a[3]));
+      break;
+    case CMD_UNIFORM_4F:
+      uniformsTouched();
+      glUniform4f(a[0], bitsFloat(a[1]), bitsFloat(a[2]), bitsFloat(a[3]), bitsFloat(a[4]));
+      break;
+    case CMD_UNIFORM_1I:
+      uniformsTouched();
+      glUniform1i(a[0], a[1]);
+      break;
+    case CMD_UNIFORM_MATRIX_4FV:
+      uniformsTouched();
+      glUniformMatrix4fv(a[0], 1, GL_FALSE, (const GLfloat *) (a + 1));
+      break;
+    case CMD_DRAW_ARRAYS:
+      glDrawArrays(a[0], a[1], a[2]);
+      break;
+    case CMD_DRAW_ELEMENTS:
+      glDrawElements(a[0], a[1], a[2], (void *) (size_t) a[3]);
+      break;
+    case CMD_DRAW_ARRAYS_INSTANCED:
+      glDrawArraysInstanced(a[0], a[1], a[2], a[3]);
+      break;
+    case CMD_DRAW_ELEMENTS_INSTANCED:
+      glDrawElementsInstanced(a[0], a[1], a[2], (void *) (size_t) a[3], a[4]);
+      break;
+    }
+  }
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdActiveTexture(SEXP cmd, unsigned int texture) {
+  record(cmd, CMD_ACTIVE_TEXTURE, texture);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdBindBuffer(SEXP cmd, unsigned int target, unsigned int buffer) {
+  record(cmd, CMD_BIND_BUFFER, target, buffer);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdBindTexture(SEXP cmd, unsigned int target, unsigned int texture) {
+  record(cmd, CMD_BIND_TEXTURE, target, texture);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdBindVertexArray(SEXP cmd, unsigned int array) {
+  record(cmd, CMD_BIND_VERTEX_ARRAY, array);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdUseProgram(SEXP cmd, unsigned int program) {
+  record(cmd, CMD_USE_PROGRAM, program);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdEnable(SEXP cmd, unsigned int cap) {
+  record(cmd, CMD_ENABLE, cap);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdDisable(SEXP cmd, unsigned int cap) {
+  record(cmd, CMD_DISABLE, cap);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdBlendFunc(SEXP cmd, unsigned int sfactor, unsigned int dfactor) {
+  record(cmd, CMD_BLEND_FUNC, sfactor, dfactor);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdDepthFunc(SEXP cmd, unsigned int func) {
+  record(cmd, CMD_DEPTH_FUNC, func);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdDepthMask(SEXP cmd, unsigned char flag) {
+  record(cmd, CMD_DEPTH_MASK, flag);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdCullFace(SEXP cmd, unsigned int mode) {
+  record(cmd, CMD_CULL_FACE, mode);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdViewport(SEXP cmd, int x, int y, int width, int height) {
+  GLuint args[] = {(GLuint) x, (GLuint) y, (GLuint) width, (GLuint) height};
+  record(cmd, CMD_VIEWPORT, args, 4);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdClearColor(SEXP cmd, float red, float green, float blue, float alpha) {
+  GLuint args[] = {floatBits(red), floatBits(green), floatBits(blue), floatBits(alpha)};
+  record(cmd, CMD_CLEAR_COLOR, args, 4);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdClear(SEXP cmd, unsigned int mask) {
+  record(cmd, CMD_CLEAR, mask);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdUniform1f(SEXP cmd, int location, float v0) {
+  record(cmd, CMD_UNIFORM_1F, location, floatBits(v0));
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdUniform2f(SEXP cmd, int location, float v0, float v1) {
+  GLuint args[] = {(GLuint) location, floatBits(v0), floatBits(v1)};
+  record(cmd, CMD_UNIFORM_2F, args, 3);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdUniform3f(SEXP cmd, int location, float v0, float v1, float v2) {
+  GLuint args[] = {(GLuint) location, floatBits(v0), floatBits(v1), floatBits(v2)};
+  record(cmd, CMD_UNIFORM_3F, args, 4);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdUniform4f(SEXP cmd, int location, float v0, float v1, float v2, float v3) {
+  GLuint args[] = {(GLuint) location, floatBits(v0), floatBits(v1), floatBits(v2), floatBits(v3)};
+  record(cmd, CMD_UNIFORM_4F, args, 5);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdUniform1i(SEXP cmd, int location, int v0) {
+  record(cmd, CMD_UNIFORM_1I, location, v0);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdUniformMatrix4fv(SEXP cmd, int location, SEXP mat) {
+  glm::mat4 value = TYPEOF(mat) == EXTPTRSXP ? *mat4Ptr(mat) : asMat4(NumericMatrix(mat));
+  GLuint args[17];
+  args[0] = location;
+  memcpy(args + 1, &value[0][0], 16 * sizeof(float));
+  record(cmd, CMD_UNIFORM_MATRIX_4FV, args, 17);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdDrawArrays(SEXP cmd, unsigned int mode, int first, int count) {
+  GLuint args[] = {mode, (GLuint) first, (GLuint) count};
+  record(cmd, CMD_DRAW_ARRAYS, args, 3);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdDrawElements(SEXP cmd, unsigned int mode, int count, unsigned int type = 0x1405, int offset = 0) {
+  GLuint args[] = {mode, (GLuint) count, type, (GLuint) offset};
+  record(cmd, CMD_DRAW_ELEMENTS, args, 4);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdDrawArraysInstanced(SEXP cmd, unsigned int mode, int first, int count, int instancecount) {
+  GLuint args[] = {mode, (GLuint) first, (GLuint) count, (GLuint) instancecount};
+  record(cmd, CMD_DRAW_ARRAYS_INSTANCED, args, 4);
+}
+
+//' @export
+// [[Rcpp::export]]
+void cmdDrawElementsInstanced(SEXP cmd, unsigned int mode, int count, unsigned int type, int instancecount, int offset = 0) {
+  GLuint args[] = {mode, (GLuint) count, type, (GLuint) offset, (GLuint) instancecount};
+  record(cmd, CMD_DRAW_ELEMENTS_INSTANCED, args, 5);
+}
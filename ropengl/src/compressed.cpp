@@ -0,0 +1,389 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <vector>
+#include <string.h>
+#include "mapped.h"
+#include "state.h"
+#include "textures.h"
+using namespace Rcpp;
+
+/*
+ * KTX (version 1) and DDS containers. The file is memory mapped and every mip level is
+ * handed to GL straight from the mapping, so nothing is copied or decoded on the CPU.
+ * Only 2D textures are accepted: no cube maps, arrays or volumes. DDS files must hold
+ * block compressed data (BC1-BC5, BC7); KTX files may hold any format GL takes, with
+ * rows padded to 4 bytes as the format requires.
+ */
+struct ImageLevel {
+  const unsigned char * data;
+  size_t size;
+  int width;
+  int height;
+};
+
+struct ContainerImage {
+  bool compressed;
+  GLenum internalFormat;
+  GLenum format;
+  GLenum type;
+  bool generateMipmaps;
+  std::vector<ImageLevel> levels;
+};
+
+static unsigned int readU32(const unsigned char * p) {
+  unsigned int v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+static int blockBytes(GLenum internalFormat) {
+  switch(internalFormat) {
+  case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RED_RGTC1:
+  case GL_COMPRESSED_SIGNED_RED_RGTC1:
+    return 8;
+  default:
+    return 16;
+  }
+}
+
+static size_t compressedLevelSize(GLenum internalFormat, int width, int height) {
+  return (size_t) ((width + 3) / 4) * ((height + 3) / 4) * blockBytes(internalFormat);
+}
+
+/* Bytes per pixel of an uncompressed format / type pair, 0 when GL would not take it */
+static int pixelBytes(GLenum format, GLenum type) {
+  switch(type) {
+  case GL_UNSIGNED_BYTE_3_3_2:
+  case GL_UNSIGNED_BYTE_2_3_3_REV:
+    return 1;
+  case GL_UNSIGNED_SHORT_5_6_5:
+  case GL_UNSIGNED_SHORT_5_6_5_REV:
+  case GL_UNSIGNED_SHORT_4_4_4_4:
+  case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+  case GL_UNSIGNED_SHORT_5_5_5_1:
+  case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+    return 2;
+  case GL_UNSIGNED_INT_8_8_8_8:
+  case GL_UNSIGNED_INT_8_8_8_8_REV:
+  case GL_UNSIGNED_INT_10_10_10_2:
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_24_8:
+  case GL_UNSIGNED_INT_10F_11F_11F_REV:
+  case GL_UNSIGNED_INT_5_9_9_9_REV:
+    return 4;
+  case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+    return 8;
+  }
+  int components;
+  switch(format) {
+  case GL_RED:
+  case GL_RED_INTEGER:
+  case GL_DEPTH_COMPONENT:
+  case GL_STENCIL_INDEX:
+    components = 1;
+    break;
+  case GL_RG:
+  case GL_RG_INTEGER:
+    components = 2;
+    break;
+  case GL_RGB:
+  case GL_BGR:
+  case GL_RGB_INTEGER:
+  case GL_BGR_INTEGER:
+    components = 3;
+    break;
+  case GL_RGBA:
+  case GL_BGRA:
+  case GL_RGBA_INTEGER:
+  case GL_BGRA_INTEGER:
+    components = 4;
+    break;
+  default:
+    return 0;
+  }
+  switch(type) {
+  case GL_UNSIGNED_BYTE:
+  case GL_BYTE:
+    return components;
+  case GL_UNSIGNED_SHORT:
+  case GL_SHORT:
+  case GL_HALF_FLOAT:
+    return components * 2;
+  case GL_UNSIGNED_INT:
+  case GL_INT:
+  case GL_FLOAT:
+    return components * 4;
+  default:
+    return 0;
+  }
+}
+
+/* Formats that need an extension beyond GL 3.2 core, NULL when GL can take it */
+static const char * missingSupport(GLenum internalFormat) {
+  switch(internalFormat) {
+  case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+  case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+  case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+    return GLAD_GL_EXT_texture_compression_s3tc ? NULL : "GL_EXT_texture_compression_s3tc";
+  case GL_COMPRESSED_RGBA_BPTC_UNORM:
+  case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+    return GLAD_GL_ARB_texture_compression_bptc ? NULL : "GL_ARB_texture_compression_bptc";
+  }
+  return NULL;
+}
+
+static GLenum ddsFourCC(unsigned int fourCC) {
+  switch(fourCC) {
+  case 0x31545844: /* DXT1 */
+    return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+  case 0x33545844: /* DXT3 */
+    return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+  case 0x35545844: /* DXT5 */
+    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  case 0x31495441: /* ATI1 */
+  case 0x55344342: /* BC4U */
+    return GL_COMPRESSED_RED_RGTC1;
+  case 0x32495441: /* ATI2 */
+  case 0x55354342: /* BC5U */
+    return GL_COMPRESSED_RG_RGTC2;
+  }
+  return 0;
+}
+
+static GLenum ddsDxgiFormat(unsigned int dxgi) {
+  switch(dxgi) {
+  case 71:
+    return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+  case 72:
+    return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+  case 74:
+    return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+  case 75:
+    return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+  case 77:
+    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  case 78:
+    return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+  case 80:
+    return GL_COMPRESSED_RED_RGTC1;
+  case 81:
+    return GL_COMPRESSED_SIGNED_RED_RGTC1;
+  case 83:
+    return GL_COMPRESSED_RG_RGTC2;
+  case 84:
+    return GL_COMPRESSED_SIGNED_RG_RGTC2;
+  case 98:
+    return GL_COMPRESSED_RGBA_BPTC_UNORM;
+  case 99:
+    return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+  }
+  return 0;
+}
+
+static std::string parseDDS(const unsigned char * p, size_t size, ContainerImage & image) {
+  if(size < 128 || readU32(p + 4) != 124) {
+    return "truncated DDS header";
+  }
+  unsigned int flags = readU32(p + 8);
+  int height = readU32(p + 12);
+  int width = readU32(p + 16);
+  unsigned int mips = (flags & 0x20000) ? readU32(p + 28) : 1;
+  unsigned int pfFlags = readU32(p + 80);
+  unsigned int fourCC = readU32(p + 84);
+  unsigned int caps2 = readU32(p + 112);
+  size_t offset = 128;
+  if((caps2 & 0x200) || (flags & 0x800000)) {
+    return "cube map and volume DDS files are not supported";
+  }
+  if(!(pfFlags & 0x4)) {
+    return "only block compressed DDS files are supported";
+  }
+  if(fourCC == 0x30315844) { /* DX10 */
+    if(size < 148) {
+      return "truncated DDS DX10 header";
+    }
+    if(readU32(p + 140) > 1) {
+      return "DDS texture arrays are not supported";
+    }
+    image.internalFormat = ddsDxgiFormat(readU32(p + 128));
+    offset = 148;
+  }
+  else {
+    image.internalFormat = ddsFourCC(fourCC);
+  }
+  if(image.internalFormat == 0) {
+    return "unsupported DDS pixel format";
+  }
+  image.compressed = true;
+  image.generateMipmaps = false;
+  for (unsigned int i = 0; i < std::max(mips, 1u) && (width > 0 || height > 0); i++) {
+    ImageLevel level;
+    level.width = std::max(width, 1);
+    level.height = std::max(height, 1);
+    level.size = compressedLevelSize(image.internalFormat, level.width, level.height);
+    level.data = p + offset;
+    if(offset + level.size > size) {
+      return "DDS file is shorter than its mip chain";
+    }
+    image.levels.push_back(level);
+    offset += level.size;
+    width /= 2;
+    height /= 2;
+  }
+  return "";
+}
+
+static const unsigned char ktxIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+static std::string parseKTX(const unsigned char * p, size_t size, ContainerImage & image) {
+  if(size < 64) {
+    return "truncated KTX header";
+  }
+  if(readU32(p + 12) != 0x04030201) {
+    return "big endian KTX files are not supported";
+  }
+  image.type = readU32(p + 16);
+  image.format = readU32(p + 24);
+  image.internalFormat = readU32(p + 28);
+  int width = readU32(p + 36);
+  int height = readU32(p + 40);
+  unsigned int depth = readU32(p + 44);
+  unsigned int elements = readU32(p + 48);
+  unsigned int faces = readU32(p + 52);
+  unsigned int mips = readU32(p + 56);
+  size_t offset = 64 + (size_t) readU32(p + 60);
+  if(depth > 0 || elements > 0 || faces != 1 || height == 0) {
+    return "only 2D KTX textures are supported";
+  }
+  if(width <= 0 || height < 0) {
+    return "invalid KTX texture size";
+  }
+  /* a full chain is at most 31 levels for an int size, which also keeps the shifts below in range */
+  unsigned int chain = 1;
+  while((std::max(width, height) >> chain) > 0) {
+    chain++;
+  }
+  if(mips > chain) {
+    return "KTX file has more mip levels than its size allows";
+  }
+  image.compressed = image.type == 0;
+  image.generateMipmaps = mips == 0;
+  int bytes = image.compressed ? 0 : pixelBytes(image.format, image.type);
+  if(!image.compressed && bytes == 0) {
+    return "unsupported KTX format and type";
+  }
+  for (unsigned int i = 0; i < std::max(mips, 1u); i++) {
+    if(offset + 4 > size) {
+      return "KTX file is shorter than its mip chain";
+    }
+    ImageLevel level;
+    level.width = std::max(width >> i, 1);
+    level.height = std::max(height >> i, 1);
+    level.size = readU32(p + offset);
+    level.data = p + offset + 4;
+    offset += 4 + level.size;
+    if(offset > size) {
+      return "KTX file is shorter than its mip chain";
+    }
+    /* GL reads rows padded to the 4 byte unpack alignment, whatever imageSize says */
+    if(!image.compressed && level.size < (((size_t) level.width * bytes + 3) & ~(size_t) 3) * level.height) {
+      return "KTX mip level " + std::to_string(i) + " is smaller than its size and format need";
+    }
+    image.levels.push_back(level);
+    offset = (offset + 3) & ~(size_t) 3;
+  }
+  return "";
+}
+
+//' Load a KTX or DDS texture
+//'
+//' Every mip level is uploaded directly from a memory mapping of the file. The texture
+//' goes through the texture cache like loadTexture, counted at its stored size.
+//' @param path KTX (version 1) or DDS file holding a 2D texture
+//' @return GL texture name
+//' @export
+// [[Rcpp::export]]
+unsigned int loadCompressedTexture(std::string path) {
+  double mtime = textureMtime(path);
+  if(mtime < 0) {
+    stop(path + ": file not found");
+  }
+  /* mip levels come from the file, so the cache's mipmaps flag is always false here */
+  GLuint texture = textureCacheLookup(path, mtime, false);
+  if(texture != 0) {
+    return texture;
+  }
+  MappedFile file(path);
+  if(!file.ok()) {
+    stop(path + ": file could not be mapped");
+  }
+  ContainerImage image;
+  std::string error;
+  if(file.size() >= 4 && memcmp(file.data(), "DDS ", 4) == 0) {
+    error = parseDDS(file.data(), file.size(), image);
+  }
+  else if(file.size() >= 12 && memcmp(file.data(), ktxIdentifier, 12) == 0) {
+    error = parseKTX(file.data(), file.size(), image);
+  }
+  else {
+    error = "not a KTX or DDS file";
+  }
+  if(error.empty() && image.compressed && missingSupport(image.internalFormat) != NULL) {
+    error = std::string("the format needs ") + missingSupport(image.internalFormat);
+  }
+  if(!error.empty()) {
+    stop(path + ": " + error);
+  }
+  texture = textureCacheStale(path);
+  if(texture == 0) {
+    glGenTextures(1, &texture);
+  }
+  GLint bound, buffer, alignment;
+  if(!cachedGetIntegerv(GL_TEXTURE_BINDING_2D, &bound)) {
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+  }
+  if(!cachedGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer)) {
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer);
+  }
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  cachedBindTexture(GL_TEXTURE_2D, texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  double bytes = 0;
+  for (size_t i = 0; i < image.levels.size(); i++) {
+    ImageLevel & level = image.levels[i];
+    if(image.compressed) {
+      glCompressedTexImage2D(GL_TEXTURE_2D, i, image.internalFormat, level.width, level.height, 0, level.size, level.data);
+    }
+    else {
+      glTexImage2D(GL_TEXTURE_2D, i, image.internalFormat, level.width, level.height, 0, image.format, image.type, level.data);
+    }
+    bytes += level.size;
+  }
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+  if(image.generateMipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+    bytes = bytes * 4 / 3;
+  }
+  else {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levels.size() - 1);
+  }
+  bool mipmapped = image.generateMipmaps || image.levels.size() > 1;
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  cachedBindTexture(GL_TEXTURE_2D, bound);
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+  textureCacheInsert(path, mtime, false, texture, bytes);
+  return texture;
+}
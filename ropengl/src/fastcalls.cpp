@@ -0,0 +1,97 @@
+#include <glad/glad.h>
+#define R_NO_REMAP
+#include <Rinternals.h>
+#include "state.h"
+#include "programs.h"
+#include "headless.h"
+
+/*
+ * Hot-path entry points that skip the Rcpp export stubs: no RNGScope, no exception
+ * trampoline, no std::string, just SEXP in and the GL call out. They are registered
+ * through R_registerRoutines with the rest of the package and resolved once in
+ * .onLoad (R/fastcalls.R), so calling one is a plain .Call on a native symbol.
+ * Conversion failures use Rf_error, which is safe here because nothing on the
+ * stack needs unwinding.
+ */
+static inline double asNumber(SEXP x) {
+  if(XLENGTH(x) > 0) {
+    switch(TYPEOF(x)) {
+    case REALSXP:
+      return REAL(x)[0];
+    case INTSXP:
+    case LGLSXP:
+      return INTEGER(x)[0];
+    }
+  }
+  Rf_error("expected a single number");
+  return 0;
+}
+
+#define ARG_U(x) ((GLuint) (long long) asNumber(x))
+#define ARG_I(x) ((GLint) asNumber(x))
+#define ARG_F(x) ((GLfloat) asNumber(x))
+
+#define FAST_CALL_1(name, fn, A) \
+  extern "C" SEXP ropengl_fast_##name(SEXP a) { fn(A(a)); return R_NilValue; }
+#define FAST_CALL_2(name, fn, A, B) \
+  extern "C" SEXP ropengl_fast_##name(SEXP a, SEXP b) { fn(A(a), B(b)); return R_NilValue; }
+#define FAST_CALL_3(name, fn, A, B, C) \
+  extern "C" SEXP ropengl_fast_##name(SEXP a, SEXP b, SEXP c) { fn(A(a), B(b), C(c)); return R_NilValue; }
+#define FAST_CALL_4(name, fn, A, B, C, D) \
+  extern "C" SEXP ropengl_fast_##name(SEXP a, SEXP b, SEXP c, SEXP d) { fn(A(a), B(b), C(c), D(d)); return R_NilValue; }
+#define FAST_CALL_5(name, fn, A, B, C, D, E) \
+  extern "C" SEXP ropengl_fast_##name(SEXP a, SEXP b, SEXP c, SEXP d, SEXP e) { fn(A(a), B(b), C(c), D(d), E(e)); return R_NilValue; }
+
+/* plain uniform uploads invalidate setUniform's value shadow */
+#define UNIFORM(fn) (uniformsTouched(), fn)
+
+FAST_CALL_1(glActiveTexture, cachedActiveTexture, ARG_U)
+FAST_CALL_2(glBindBuffer, cachedBindBuffer, ARG_U, ARG_U)
+FAST_CALL_2(glBindFramebuffer, bindFramebuffer, ARG_U, ARG_U)
+FAST_CALL_2(glBindRenderbuffer, cachedBindRenderbuffer, ARG_U, ARG_U)
+FAST_CALL_2(glBindTexture, cachedBindTexture, ARG_U, ARG_U)
+FAST_CALL_1(glBindVertexArray, cachedBindVertexArray, ARG_U)
+FAST_CALL_4(glBlendColor, cachedBlendColor, ARG_F, ARG_F, ARG_F, ARG_F)
+FAST_CALL_1(glBlendEquation, cachedBlendEquation, ARG_U)
+FAST_CALL_2(glBlendFunc, cachedBlendFunc, ARG_U, ARG_U)
+FAST_CALL_1(glClear, glClear, ARG_U)
+FAST_CALL_4(glClearColor, glClearColor, ARG_F, ARG_F, ARG_F, ARG_F)
+FAST_CALL_4(glColorMask, glColorMask, ARG_U, ARG_U, ARG_U, ARG_U)
+FAST_CALL_1(glCullFace, cachedCullFace, ARG_U)
+FAST_CALL_1(glDepthFunc, cachedDepthFunc, ARG_U)
+FAST_CALL_1(glDepthMask, cachedDepthMask, ARG_U)
+FAST_CALL_1(glDisable, cachedDisable, ARG_U)
+FAST_CALL_1(glDisableVertexAttribArray, glDisableVertexAttribArray, ARG_U)
+FAST_CALL_3(glDrawArrays, glDrawArrays, ARG_U, ARG_I, ARG_I)
+FAST_CALL_1(glEnable, cachedEnable, ARG_U)
+FAST_CALL_1(glEnableVertexAttribArray, glEnableVertexAttribArray, ARG_U)
+FAST_CALL_1(glFrontFace, cachedFrontFace, ARG_U)
+FAST_CALL_1(glLineWidth, glLineWidth, ARG_F)
+FAST_CALL_2(glPolygonOffset, glPolygonOffset, ARG_F, ARG_F)
+FAST_CALL_4(glScissor, glScissor, ARG_I, ARG_I, ARG_I, ARG_I)
+FAST_CALL_3(glStencilFunc, cachedStencilFunc, ARG_U, ARG_I, ARG_U)
+FAST_CALL_1(glStencilMask, cachedStencilMask, ARG_U)
+FAST_CALL_3(glStencilOp, cachedStencilOp, ARG_U, ARG_U, ARG_U)
+FAST_CALL_2(glUniform1f, UNIFORM(glUniform1f), ARG_I, ARG_F)
+FAST_CALL_3(glUniform2f, UNIFORM(glUniform2f), ARG_I, ARG_F, ARG_F)
+FAST_CALL_4(glUniform3f, UNIFORM(glUniform3f), ARG_I, ARG_F, ARG_F, ARG_F)
+FAST_CALL_5(glUniform4f, UNIFORM(glUniform4f), ARG_I, ARG_F, ARG_F, ARG_F, ARG_F)
+FAST_CALL_2(glUniform1i, UNIFORM(glUniform1i), ARG_I, ARG_I)
+FAST_CALL_3(glUniform2i, UNIFORM(glUniform2i), ARG_I, ARG_I, ARG_I)
+FAST_CALL_4(glUniform3i, UNIFORM(glUniform3i), ARG_I, ARG_I, ARG_I, ARG_I)
+FAST_CALL_5(glUniform4i, UNIFORM(glUniform4i), ARG_I, ARG_I, ARG_I, ARG_I, ARG_I)
+FAST_CALL_1(glUseProgram, cachedUseProgram, ARG_U)
+FAST_CALL_2(glVertexAttrib1f, glVertexAttrib1f, ARG_U, ARG_F)
+FAST_CALL_3(glVertexAttrib2f, glVertexAttrib2f, ARG_U, ARG_F, ARG_F)
+FAST_CALL_4(glVertexAttrib3f, glVertexAttrib3f, ARG_U, ARG_F, ARG_F, ARG_F)
+FAST_CALL_5(glVertexAttrib4f, glVertexAttrib4f, ARG_U, ARG_F, ARG_F, ARG_F, ARG_F)
+FAST_CALL_4(glViewport, glViewport, ARG_I, ARG_I, ARG_I, ARG_I)
+
+extern "C" SEXP ropengl_fast_glDrawElements(SEXP mode, SEXP count, SEXP type) {
+  glDrawElements(ARG_U(mode), ARG_I(count), ARG_U(type), (void *) 0);
+  return R_NilValue;
+}
+
+extern "C" SEXP ropengl_fast_glGetError() {
+  return Rf_ScalarInteger(glGetError());
+}
@@ -4,10 +4,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <iostream>
-#include <fstream>
 #include <map>
 #include <vector>
 #include <iterator>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 #include <glm/gtc/noise.hpp>
@@ -16,6 +16,19 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "linmath.h"
+#include "simd.h"
+#include "ropengl.h"
+#include "state.h"
+#include "programs.h"
+#include "instances.h"
+#include "textures.h"
+#include "mapped.h"
+#include "shaders.h"
+#include "input.h"
+#include "pacing.h"
+#include "headless.h"
+#include "readback.h"
+#include "capture.h"
 using namespace Rcpp;
 using namespace std;
 
@@ -433,18 +446,11 @@ void initFlagMap() {
 //' @export
 // [[Rcpp::export]]
 std::string readFile (std::string name) {
-  ifstream file;
-  std::string output = "";
-  file.open(name.c_str());
-  if(!file) {
-    return "FILE COULD NOT BE OPENED";
+  MappedFile file(name);
+  if(!file.ok()) {
+    stop(name + ": file could not be opened");
   }
-  while(file.good()) {
-    std::string line;
-    getline(file, line);
-    output += line;
-  }
-  return output;
+  return std::string((const char *) file.data(), file.size());
 }
 
 std::map<std::string, int> keys;
@@ -460,8 +466,18 @@ GLFWwindow * window;
 //' @export
 // [[Rcpp::export]]
 void flip(){
-  glfwSwapBuffers(window);
-  glfwPollEvents();
+  captureFrame();
+  waitForFrame();
+  if(window != NULL) {
+    glfwSwapBuffers(window);
+    glfwPollEvents();
+  }
+  else {
+    glFlush();
+  }
+  recordFrame();
+  uploadPendingTextures(-1);
+  reloadChangedPrograms();
 }
 
 NumericVector asNumericVector(glm::vec3 vec, int len = 3) {
@@ -563,7 +579,26 @@ NumericVector cross (NumericVector a, NumericVector b) {
 //' @export
 // [[Rcpp::export]]
 int getKeyId (std::string name) {
-  return keys[name];
+  std::map<std::string, int>::iterator key = keys.find(name);
+  if(key == keys.end()) {
+    stop("unknown key name: " + name);
+  }
+  return key->second;
+}
+
+//' Resolve key names to GLFW key codes
+//'
+//' Meant to be called once at setup; the codes index keyboardState().
+//' @param names key names as returned by getKeyName
+//' @return integer vector of key codes, an error for any unknown name
+//' @export
+// [[Rcpp::export]]
+IntegerVector keyCodes(CharacterVector names) {
+  IntegerVector codes(names.size());
+  for (R_xlen_t i = 0; i < names.size(); i++) {
+    codes[i] = getKeyId(as<std::string>(names[i]));
+  }
+  return codes;
 }
 
 //' @export
@@ -622,6 +657,7 @@ double mouseX;
 double mouseY;
 
 void mouseButtonCallback (GLFWwindow * window, int button, int action, int mods) {
+  recordInputEvent(INPUT_BUTTON, button, action, mods, mouseX, mouseY);
   if(button == GLFW_MOUSE_BUTTON_LEFT) {
     leftMouseButton = action;
   }
@@ -648,11 +684,13 @@ void setCursorPos(double x, double y) {
 }
 
 void scrollCallback(GLFWwindow * window, double x, double y) {
+  recordInputEvent(INPUT_SCROLL, 0, 0, 0, x, y);
   scrollX = x;
   scrollY = y;
 }
 
 void cursorCallback(GLFWwindow * window, double x, double y) {
+  recordInputEvent(INPUT_CURSOR, 0, 0, 0, x, y);
   mouseX = x;
   mouseY = y;
 }
@@ -674,9 +712,10 @@ std::vector<double> getScrollWheel() {
 //' @param y desired window height
 //' @param name desired window name
 //' @param fullScreen whether or not window is full screen
+//' @param swapInterval vertical blanks each flip waits for, 0 for no vsync
 //' @export
 // [[Rcpp::export]]
-void createWindow(int x, int y, const char* name, bool fullScreen = false) {
+void createWindow(int x, int y, const char* name, bool fullScreen = false, int swapInterval = 1) {
   /* Initialize Module */
   glfwInit();
   initFlagMap();
@@ -694,15 +733,17 @@ void createWindow(int x, int y, const char* name, bool fullScreen = false) {
   
   glfwMakeContextCurrent(window);
   gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
+  cachedReset();
   int width, height;
   glfwGetFramebufferSize(window, &width, &height);
   glViewport(0, 0, width, height);
   
-  glfwSwapInterval(1);
+  glfwSwapInterval(swapInterval);
   
   glfwSetMouseButtonCallback(window, mouseButtonCallback);
   glfwSetScrollCallback(window, scrollCallback);
   glfwSetCursorPosCallback(window, cursorCallback);
+  installInputCallbacks(window);
 }
 
 //' Focus input on graphics window
@@ -748,6 +789,7 @@ void myGlShaderSource(unsigned int shader, std::string a, int count = 1) {
   char * const s = r;
   char * const * e = &s;
   glShaderSource(shader, count, e, NULL);
+  noteShaderSource(shader, a);
 }
 
 //' @export
@@ -764,21 +806,21 @@ std::vector<int> myGlGenVertexArrays (int n) {
 // [[Rcpp::export(name = "glDeleteVertexArrays")]]
 void myGlDeleteVertexArrays (int n, std::vector<unsigned int> arrays) {
   
-  glDeleteVertexArrays(n, &arrays[0]);
+  cachedDeleteVertexArrays(n, &arrays[0]);
   
 }
 
 //' @export
 // [[Rcpp::export(name = "glBindVertexArray")]]
 void myGlBindVertexArray (unsigned int array) {
-  glBindVertexArray(array);
+  cachedBindVertexArray(array);
 }
 
 //' @export
 // [[Rcpp::export(name = 'glActiveTexture')]]
 void myGlActiveTexture(unsigned int texture) {
   
-  glActiveTexture(texture);
+  cachedActiveTexture(texture);
   
 }
 
@@ -802,7 +844,7 @@ void myGlBindAttribLocation(unsigned int program, unsigned int index, std::strin
 // [[Rcpp::export(name = 'glBindBuffer')]]
 void myGlBindBuffer(unsigned int target, unsigned int buffer) {
   
-  glBindBuffer(target, buffer);
+  cachedBindBuffer(target, buffer);
   
 }
 
@@ -810,7 +852,7 @@ void myGlBindBuffer(unsigned int target, unsigned int buffer) {
 // [[Rcpp::export(name = 'glBindFramebuffer')]]
 void myGlBindFramebuffer(unsigned int target, unsigned int framebuffer) {
   
-  glBindFramebuffer(target, framebuffer);
+  bindFramebuffer(target, framebuffer);
   
 }
 
@@ -818,7 +860,7 @@ void myGlBindFramebuffer(unsigned int target, unsigned int framebuffer) {
 // [[Rcpp::export(name = 'glBindRenderbuffer')]]
 void myGlBindRenderbuffer(unsigned int target, unsigned int renderbuffer) {
   
-  glBindRenderbuffer(target, renderbuffer);
+  cachedBindRenderbuffer(target, renderbuffer);
   
 }
 
@@ -826,7 +868,7 @@ void myGlBindRenderbuffer(unsigned int target, unsigned int renderbuffer) {
 // [[Rcpp::export(name = 'glBindTexture')]]
 void myGlBindTexture(unsigned int target, unsigned int texture) {
   
-  glBindTexture(target, texture);
+  cachedBindTexture(target, texture);
   
 }
 
@@ -834,7 +876,7 @@ void myGlBindTexture(unsigned int target, unsigned int texture) {
 // [[Rcpp::export(name = 'glBlendColor')]]
 void myGlBlendColor(float red, float green, float blue, float alpha) {
   
-  glBlendColor(red, green, blue, alpha);
+  cachedBlendColor(red, green, blue, alpha);
   
 }
 
@@ -842,7 +884,7 @@ void myGlBlendColor(float red, float green, float blue, float alpha) {
 // [[Rcpp::export(name = 'glBlendEquation')]]
 void myGlBlendEquation(unsigned int mode) {
   
-  glBlendEquation(mode);
+  cachedBlendEquation(mode);
   
 }
 
@@ -850,7 +892,7 @@ void myGlBlendEquation(unsigned int mode) {
 // [[Rcpp::export(name = 'glBlendEquationSeparate')]]
 void myGlBlendEquationSeparate(unsigned int modeRGB, unsigned int modeAlpha) {
   
-  glBlendEquationSeparate(modeRGB, modeAlpha);
+  cachedBlendEquationSeparate(modeRGB, modeAlpha);
   
 }
 
@@ -858,7 +900,7 @@ void myGlBlendEquationSeparate(unsigned int modeRGB, unsigned int modeAlpha) {
 // [[Rcpp::export(name = 'glBlendFunc')]]
 void myGlBlendFunc(unsigned int sfactor, unsigned int dfactor) {
   
-  glBlendFunc(sfactor, dfactor);
+  cachedBlendFunc(sfactor, dfactor);
   
 }
 
@@ -866,30 +908,65 @@ void myGlBlendFunc(unsigned int sfactor, unsigned int dfactor) {
 // [[Rcpp::export(name = 'glBlendFuncSeparate')]]
 void myGlBlendFuncSeparate(unsigned int sfactorRGB, unsigned int dfactorRGB, unsigned int sfactorAlpha, unsigned int dfactorAlpha) {
   
-  glBlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+  cachedBlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
   
 }
 
+/* Doubles are narrowed through a small reusable staging buffer, one cache-sized chunk at a time */
+static const size_t UPLOAD_CHUNK = 16384;
+static std::vector<unsigned int> uploadStaging(UPLOAD_CHUNK);
+
+static void uploadNarrowed(unsigned int target, GLintptr offset, const double * src, size_t n, bool elementArray) {
+  for (size_t done = 0; done < n; done += UPLOAD_CHUNK) {
+    size_t len = std::min(UPLOAD_CHUNK, n - done);
+    if(elementArray) {
+      narrowToUint(src + done, &uploadStaging[0], len);
+    }
+    else {
+      narrowToFloat(src + done, (float *) &uploadStaging[0], len);
+    }
+    glBufferSubData(target, offset + done * 4, len * 4, &uploadStaging[0]);
+  }
+}
+
+/* Integer and raw vectors are handed to GL as-is, numeric vectors become float (or uint for element arrays) */
 //' @export
 // [[Rcpp::export(name = 'glBufferData')]]
-void myGlBufferData(unsigned int target, std::vector<float> data, unsigned int usage, bool elementArray = false) {
-  if(elementArray) {
-    GLsizeiptr size = data.size() * sizeof(data[0]);
-    std::vector<unsigned int> yeet (data.begin(), data.end());
-    glBufferData(target, size, & yeet[0], usage);
-  }
-  else {
-    GLsizeiptr size = data.size() * sizeof(data[0]);
-    glBufferData(target, size,  & data[0], usage);
+void myGlBufferData(unsigned int target, SEXP data, unsigned int usage, bool elementArray = false) {
+  size_t n = XLENGTH(data);
+  switch(TYPEOF(data)) {
+  case INTSXP:
+    glBufferData(target, n * sizeof(int), INTEGER(data), usage);
+    break;
+  case RAWSXP:
+    glBufferData(target, n, RAW(data), usage);
+    break;
+  case REALSXP:
+    glBufferData(target, n * 4, NULL, usage);
+    uploadNarrowed(target, 0, REAL(data), n, elementArray);
+    break;
+  default:
+    stop("glBufferData: data must be a numeric, integer or raw vector");
   }
 }
 
 //' @export
 // [[Rcpp::export(name = 'glBufferSubData')]]
-void myGlBufferSubData(unsigned int target, long long int offset, long long int size, std::vector<float> data) {
-  
-  glBufferSubData(target, offset, size,  & data[0]);
-  
+void myGlBufferSubData(unsigned int target, long long int offset, long long int size, SEXP data, bool elementArray = false) {
+  size_t n = XLENGTH(data);
+  switch(TYPEOF(data)) {
+  case INTSXP:
+    glBufferSubData(target, offset, std::min((size_t) size, n * sizeof(int)), INTEGER(data));
+    break;
+  case RAWSXP:
+    glBufferSubData(target, offset, std::min((size_t) size, n), RAW(data));
+    break;
+  case REALSXP:
+    uploadNarrowed(target, offset, REAL(data), std::min((size_t) size / 4, n), elementArray);
+    break;
+  default:
+    stop("glBufferSubData: data must be a numeric, integer or raw vector");
+  }
 }
 
 //' @export
@@ -950,18 +1027,20 @@ void myGlCompileShader(unsigned int shader) {
 
 //' @export
 // [[Rcpp::export(name = 'glCompressedTexImage2D')]]
-void myGlCompressedTexImage2D(unsigned int target, int level, unsigned int internalformat, int width, int height, int border, int imageSize, std::vector<float> data) {
-  
-  glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize,  & data[0]);
-  
+void myGlCompressedTexImage2D(unsigned int target, int level, unsigned int internalformat, int width, int height, int border, int imageSize, RawVector data) {
+  if(imageSize > data.size()) {
+    stop("imageSize is larger than data");
+  }
+  glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data.begin());
 }
 
 //' @export
 // [[Rcpp::export(name = 'glCompressedTexSubImage2D')]]
-void myGlCompressedTexSubImage2D(unsigned int target, int level, int xoffset, int yoffset, int width, int height, unsigned int format, int imageSize, std::vector<float> data) {
-  
-  glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize,  & data[0]);
-  
+void myGlCompressedTexSubImage2D(unsigned int target, int level, int xoffset, int yoffset, int width, int height, unsigned int format, int imageSize, RawVector data) {
+  if(imageSize > data.size()) {
+    stop("imageSize is larger than data");
+  }
+  glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data.begin());
 }
 
 //' @export
@@ -1000,7 +1079,7 @@ unsigned int myGlCreateShader(unsigned int type) {
 // [[Rcpp::export(name = 'glCullFace')]]
 void myGlCullFace(unsigned int mode) {
   
-  glCullFace(mode);
+  cachedCullFace(mode);
   
 }
 
@@ -1008,7 +1087,7 @@ void myGlCullFace(unsigned int mode) {
 // [[Rcpp::export(name = 'glDeleteBuffers')]]
 void myGlDeleteBuffers(int n, std::vector<unsigned int> buffers) {
   
-  glDeleteBuffers(n,  & buffers[0]);
+  cachedDeleteBuffers(n,  & buffers[0]);
   
 }
 
@@ -1016,7 +1095,7 @@ void myGlDeleteBuffers(int n, std::vector<unsigned int> buffers) {
 // [[Rcpp::export(name = 'glDeleteFramebuffers')]]
 void myGlDeleteFramebuffers(int n, std::vector<unsigned int> framebuffers) {
   
-  glDeleteFramebuffers(n,  & framebuffers[0]);
+  cachedDeleteFramebuffers(n,  & framebuffers[0]);
   
 }
 
@@ -1024,6 +1103,8 @@ void myGlDeleteFramebuffers(int n, std::vector<unsigned int> framebuffers) {
 // [[Rcpp::export(name = 'glDeleteProgram')]]
 void myGlDeleteProgram(unsigned int program) {
   
+  forgetProgram(program);
+  unwatchProgram(program);
   glDeleteProgram(program);
   
 }
@@ -1032,23 +1113,23 @@ void myGlDeleteProgram(unsigned int program) {
 // [[Rcpp::export(name = 'glDeleteRenderbuffers')]]
 void myGlDeleteRenderbuffers(int n, std::vector<unsigned int> renderbuffers) {
   
-  glDeleteRenderbuffers(n,  & renderbuffers[0]);
+  cachedDeleteRenderbuffers(n,  & renderbuffers[0]);
   
 }
 
 //' @export
 // [[Rcpp::export(name = 'glDeleteShader')]]
 void myGlDeleteShader(unsigned int shader) {
-  
+  forgetShaderSource(shader);
   glDeleteShader(shader);
-  
 }
 
 //' @export
 // [[Rcpp::export(name = 'glDeleteTextures')]]
 void myGlDeleteTextures(int n, std::vector<unsigned int> textures) {
   
-  glDeleteTextures(n,  & textures[0]);
+  textureCacheForget(n,  & textures[0]);
+  cachedDeleteTextures(n,  & textures[0]);
   
 }
 
@@ -1056,7 +1137,7 @@ void myGlDeleteTextures(int n, std::vector<unsigned int> textures) {
 // [[Rcpp::export(name = 'glDepthFunc')]]
 void myGlDepthFunc(unsigned int func) {
   
-  glDepthFunc(func);
+  cachedDepthFunc(func);
   
 }
 
@@ -1064,7 +1145,7 @@ void myGlDepthFunc(unsigned int func) {
 // [[Rcpp::export(name = 'glDepthMask')]]
 void myGlDepthMask(unsigned char flag) {
   
-  glDepthMask(flag);
+  cachedDepthMask(flag);
   
 }
 
@@ -1088,7 +1169,7 @@ void myGlDetachShader(unsigned int program, unsigned int shader) {
 // [[Rcpp::export(name = 'glDisable')]]
 void myGlDisable(unsigned int cap) {
   
-  glDisable(cap);
+  cachedDisable(cap);
   
 }
 
@@ -1108,6 +1189,14 @@ void myGlDrawArrays(unsigned int mode, int first, int count) {
   
 }
 
+//' @export
+// [[Rcpp::export(name = 'glDrawArraysInstanced')]]
+void myGlDrawArraysInstanced(unsigned int mode, int first, int count, int instancecount) {
+  
+  glDrawArraysInstanced(mode, first, count, instancecount);
+  
+}
+
 //' @export
 // [[Rcpp::export(name = 'glDrawElements')]]
 void myGlDrawElements(unsigned int mode, int count, unsigned int type) {
@@ -1116,11 +1205,19 @@ void myGlDrawElements(unsigned int mode, int count, unsigned int type) {
   
 }
 
+//' @export
+// [[Rcpp::export(name = 'glDrawElementsInstanced')]]
+void myGlDrawElementsInstanced(unsigned int mode, int count, unsigned int type, int instancecount, int offset = 0) {
+  
+  glDrawElementsInstanced(mode, count, type, (void*) (size_t) offset, instancecount);
+  
+}
+
 //' @export
 // [[Rcpp::export(name = 'glEnable')]]
 void myGlEnable(unsigned int cap) {
   
-  glEnable(cap);
+  cachedEnable(cap);
   
 }
 
@@ -1168,7 +1265,7 @@ void myGlFramebufferTexture2D(unsigned int target, unsigned int attachment, unsi
 // [[Rcpp::export(name = 'glFrontFace')]]
 void myGlFrontFace(unsigned int mode) {
   
-  glFrontFace(mode);
+  cachedFrontFace(mode);
   
 }
 
@@ -1216,7 +1313,7 @@ std::vector<unsigned int> myGlGenTextures(int n) {
 // [[Rcpp::export(name = 'glGetAttribLocation')]]
 int myGlGetAttribLocation(unsigned int program, std::string name) {
   
-  return glGetAttribLocation(program,  & name[0]);
+  return cachedAttribLocation(program, name);
   
 }
 
@@ -1256,7 +1353,9 @@ std::vector<int> myGlGetFramebufferAttachmentParameteriv(unsigned int target, un
 // [[Rcpp::export(name = 'glGetIntegerv')]]
 std::vector<int> myGlGetIntegerv(unsigned int pname, int n = 1) {
   int data[n];
-  glGetIntegerv(pname, data);
+  if(n != 1 || !cachedGetIntegerv(pname, data)) {
+    glGetIntegerv(pname, data);
+  }
   return std::vector<int>(data, data + sizeof data / sizeof data[0]);
 }
 
@@ -1284,6 +1383,31 @@ std::vector<int> myGlGetShaderiv(unsigned int shader, unsigned int pname, int n
   return std::vector<int>(params, params + sizeof params / sizeof params[0]);
 }
 
+//' Shader info log
+//'
+//' For shaders whose source came from loadShaderSource, the #line source numbers are
+//' replaced by the names of the files they stand for.
+//' @param shader shader name
+//' @export
+// [[Rcpp::export(name = 'glGetShaderInfoLog')]]
+std::string myGlGetShaderInfoLog(unsigned int shader) {
+  GLint length = 0;
+  glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+  std::vector<char> log(length + 1, 0);
+  glGetShaderInfoLog(shader, length + 1, NULL, &log[0]);
+  return mapShaderLog(shader, &log[0]);
+}
+
+//' @export
+// [[Rcpp::export(name = 'glGetProgramInfoLog')]]
+std::string myGlGetProgramInfoLog(unsigned int program) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+  std::vector<char> log(length + 1, 0);
+  glGetProgramInfoLog(program, length + 1, NULL, &log[0]);
+  return &log[0];
+}
+
 //' @export
 // [[Rcpp::export(name = 'glGetTexParameterfv')]]
 std::vector<float> myGlGetTexParameterfv(unsigned int target, unsigned int pname, int n = 1) {
@@ -1320,7 +1444,7 @@ std::vector<int> myGlGetUniformiv(unsigned int program, int location, int n = 1)
 // [[Rcpp::export(name = 'glGetUniformLocation')]]
 int myGlGetUniformLocation(unsigned int program, std::string name) {
   
-  return glGetUniformLocation(program,  & name[0]);
+  return cachedUniformLocation(program, name);
   
 }
 
@@ -1360,6 +1484,10 @@ unsigned char myGlIsBuffer(unsigned int buffer) {
 // [[Rcpp::export(name = 'glIsEnabled')]]
 unsigned char myGlIsEnabled(unsigned int cap) {
   
+  GLboolean enabled;
+  if(cachedIsEnabled(cap, &enabled)) {
+    return enabled;
+  }
   return glIsEnabled(cap);
   
 }
@@ -1417,6 +1545,14 @@ void myGlLineWidth(float width) {
 void myGlLinkProgram(unsigned int program) {
   
   glLinkProgram(program);
+  GLint status;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if(status == GL_TRUE) {
+    reflectProgram(program);
+  }
+  else {
+    forgetProgram(program);
+  }
   
 }
 
@@ -1438,10 +1574,23 @@ void myGlPolygonOffset(float factor, float units) {
 
 //' @export
 // [[Rcpp::export(name = 'glReadPixels')]]
-std::vector<float> myGlReadPixels(int x, int y, int width, int height, unsigned int format, unsigned int type, int n = 1) {
-  float pixels [n];
-  glReadPixels(x, y, width, height, format, type,  pixels);
-  return std::vector<float>(pixels, pixels + sizeof pixels / sizeof pixels[0]);
+SEXP myGlReadPixels(int x, int y, int width, int height, unsigned int format, unsigned int type, int n = 1) {
+  /* n is unused: the size follows from the rectangle, format and type */
+  if(width <= 0 || height <= 0) {
+    stop("width and height must be positive");
+  }
+  std::vector<unsigned char> pixels(pixelBytes(format, type) * width * height);
+  GLint buffer, alignment;
+  if(!cachedGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &buffer)) {
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &buffer);
+  }
+  glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(x, y, width, height, format, type, &pixels[0]);
+  glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  return pixelVector(&pixels[0], width, height, format, type);
 }
 
 //' @export
@@ -1480,7 +1629,7 @@ void myGlScissor(int x, int y, int width, int height) {
 // [[Rcpp::export(name = 'glStencilFunc')]]
 void myGlStencilFunc(unsigned int func, int ref, unsigned int mask) {
   
-  glStencilFunc(func, ref, mask);
+  cachedStencilFunc(func, ref, mask);
   
 }
 
@@ -1488,7 +1637,7 @@ void myGlStencilFunc(unsigned int func, int ref, unsigned int mask) {
 // [[Rcpp::export(name = 'glStencilFuncSeparate')]]
 void myGlStencilFuncSeparate(unsigned int face, unsigned int func, int ref, unsigned int mask) {
   
-  glStencilFuncSeparate(face, func, ref, mask);
+  cachedStencilFuncSeparate(face, func, ref, mask);
   
 }
 
@@ -1496,7 +1645,7 @@ void myGlStencilFuncSeparate(unsigned int face, unsigned int func, int ref, unsi
 // [[Rcpp::export(name = 'glStencilMask')]]
 void myGlStencilMask(unsigned int mask) {
   
-  glStencilMask(mask);
+  cachedStencilMask(mask);
   
 }
 
@@ -1504,7 +1653,7 @@ void myGlStencilMask(unsigned int mask) {
 // [[Rcpp::export(name = 'glStencilMaskSeparate')]]
 void myGlStencilMaskSeparate(unsigned int face, unsigned int mask) {
   
-  glStencilMaskSeparate(face, mask);
+  cachedStencilMaskSeparate(face, mask);
   
 }
 
@@ -1512,7 +1661,7 @@ void myGlStencilMaskSeparate(unsigned int face, unsigned int mask) {
 // [[Rcpp::export(name = 'glStencilOp')]]
 void myGlStencilOp(unsigned int fail, unsigned int zfail, unsigned int zpass) {
   
-  glStencilOp(fail, zfail, zpass);
+  cachedStencilOp(fail, zfail, zpass);
   
 }
 
@@ -1520,7 +1669,7 @@ void myGlStencilOp(unsigned int fail, unsigned int zfail, unsigned int zpass) {
 // [[Rcpp::export(name = 'glStencilOpSeparate')]]
 void myGlStencilOpSeparate(unsigned int face, unsigned int sfail, unsigned int dpfail, unsigned int dppass) {
   
-  glStencilOpSeparate(face, sfail, dpfail, dppass);
+  cachedStencilOpSeparate(face, sfail, dpfail, dppass);
   
 }
 
@@ -1529,7 +1678,17 @@ void myGlStencilOpSeparate(unsigned int face, unsigned int sfail, unsigned int d
 void myGlTexImage2D(const char * fname) {
   int width, height, chan;
   unsigned char * data = stbi_load(fname, &width, &height, &chan, 0);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+  if(data == NULL) {
+    stop(std::string(fname) + ": " + stbi_failure_reason());
+  }
+  GLenum internalFormat, format;
+  GLint alignment;
+  textureFormats(chan, &internalFormat, &format);
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  stbi_image_free(data);
 }
 
 //' @export
@@ -1576,6 +1735,7 @@ void myGlTexSubImage2D(unsigned int target, int level, int xoffset, int yoffset,
 // [[Rcpp::export(name = 'glUniform1f')]]
 void myGlUniform1f(int location, float v0) {
   
+  uniformsTouched();
   glUniform1f(location, v0);
   
 }
@@ -1584,6 +1744,7 @@ void myGlUniform1f(int location, float v0) {
 // [[Rcpp::export(name = 'glUniform1fv')]]
 void myGlUniform1fv(int location, int count, std::vector<float> value) {
   
+  uniformsTouched();
   glUniform1fv(location, count,  & value[0]);
   
 }
@@ -1592,6 +1753,7 @@ void myGlUniform1fv(int location, int count, std::vector<float> value) {
 // [[Rcpp::export(name = 'glUniform1i')]]
 void myGlUniform1i(int location, int v0) {
   
+  uniformsTouched();
   glUniform1i(location, v0);
   
 }
@@ -1600,6 +1762,7 @@ void myGlUniform1i(int location, int v0) {
 // [[Rcpp::export(name = 'glUniform1iv')]]
 void myGlUniform1iv(int location, int count, std::vector<int> value) {
   
+  uniformsTouched();
   glUniform1iv(location, count,  & value[0]);
   
 }
@@ -1608,6 +1771,7 @@ void myGlUniform1iv(int location, int count, std::vector<int> value) {
 // [[Rcpp::export(name = 'glUniform2f')]]
 void myGlUniform2f(int location, float v0, float v1) {
   
+  uniformsTouched();
   glUniform2f(location, v0, v1);
   
 }
@@ -1616,6 +1780,7 @@ void myGlUniform2f(int location, float v0, float v1) {
 // [[Rcpp::export(name = 'glUniform2fv')]]
 void myGlUniform2fv(int location, int count, std::vector<float> value) {
   
+  uniformsTouched();
   glUniform2fv(location, count,  & value[0]);
   
 }
@@ -1624,6 +1789,7 @@ void myGlUniform2fv(int location, int count, std::vector<float> value) {
 // [[Rcpp::export(name = 'glUniform2i')]]
 void myGlUniform2i(int location, int v0, int v1) {
   
+  uniformsTouched();
   glUniform2i(location, v0, v1);
   
 }
@@ -1632,6 +1798,7 @@ void myGlUniform2i(int location, int v0, int v1) {
 // [[Rcpp::export(name = 'glUniform2iv')]]
 void myGlUniform2iv(int location, int count, std::vector<int> value) {
   
+  uniformsTouched();
   glUniform2iv(location, count,  & value[0]);
   
 }
@@ -1640,6 +1807,7 @@ void myGlUniform2iv(int location, int count, std::vector<int> value) {
 // [[Rcpp::export(name = 'glUniform3f')]]
 void myGlUniform3f(int location, float v0, float v1, float v2) {
   
+  uniformsTouched();
   glUniform3f(location, v0, v1, v2);
   
 }
@@ -1648,6 +1816,7 @@ void myGlUniform3f(int location, float v0, float v1, float v2) {
 // [[Rcpp::export(name = 'glUniform3fv')]]
 void myGlUniform3fv(int location, int count, std::vector<float> value) {
   
+  uniformsTouched();
   glUniform3fv(location, count,  & value[0]);
   
 }
@@ -1656,6 +1825,7 @@ void myGlUniform3fv(int location, int count, std::vector<float> value) {
 // [[Rcpp::export(name = 'glUniform3i')]]
 void myGlUniform3i(int location, int v0, int v1, int v2) {
   
+  uniformsTouched();
   glUniform3i(location, v0, v1, v2);
   
 }
@@ -1664,6 +1834,7 @@ void myGlUniform3i(int location, int v0, int v1, int v2) {
 // [[Rcpp::export(name = 'glUniform3iv')]]
 void myGlUniform3iv(int location, int count, std::vector<int> value) {
   
+  uniformsTouched();
   glUniform3iv(location, count,  & value[0]);
   
 }
@@ -1672,6 +1843,7 @@ void myGlUniform3iv(int location, int count, std::vector<int> value) {
 // [[Rcpp::export(name = 'glUniform4f')]]
 void myGlUniform4f(int location, float v0, float v1, float v2, float v3) {
   
+  uniformsTouched();
   glUniform4f(location, v0, v1, v2, v3);
   
 }
@@ -1680,6 +1852,7 @@ void myGlUniform4f(int location, float v0, float v1, float v2, float v3) {
 // [[Rcpp::export(name = 'glUniform4fv')]]
 void myGlUniform4fv(int location, int count, std::vector<float> value) {
   
+  uniformsTouched();
   glUniform4fv(location, count,  & value[0]);
   
 }
@@ -1688,6 +1861,7 @@ void myGlUniform4fv(int location, int count, std::vector<float> value) {
 // [[Rcpp::export(name = 'glUniform4i')]]
 void myGlUniform4i(int location, int v0, int v1, int v2, int v3) {
   
+  uniformsTouched();
   glUniform4i(location, v0, v1, v2, v3);
   
 }
@@ -1696,6 +1870,7 @@ void myGlUniform4i(int location, int v0, int v1, int v2, int v3) {
 // [[Rcpp::export(name = 'glUniform4iv')]]
 void myGlUniform4iv(int location, int count, std::vector<int> value) {
   
+  uniformsTouched();
   glUniform4iv(location, count,  & value[0]);
   
 }
@@ -1704,6 +1879,7 @@ void myGlUniform4iv(int location, int count, std::vector<int> value) {
 // [[Rcpp::export(name = 'glUniformMatrix2fv')]]
 void myGlUniformMatrix2fv(int location, int count, unsigned char transpose, std::vector<float> value) {
   
+  uniformsTouched();
   glUniformMatrix2fv(location, count, transpose,  & value[0]);
   
 }
@@ -1712,6 +1888,7 @@ void myGlUniformMatrix2fv(int location, int count, unsigned char transpose, std:
 // [[Rcpp::export(name = 'glUniformMatrix3fv')]]
 void myGlUniformMatrix3fv(int location, int count, unsigned char transpose, std::vector<float> value) {
   
+  uniformsTouched();
   glUniformMatrix3fv(location, count, transpose,  & value[0]);
   
 }
@@ -1720,6 +1897,7 @@ void myGlUniformMatrix3fv(int location, int count, unsigned char transpose, std:
 // [[Rcpp::export(name = 'glUniformMatrix4fv')]]
 void myGlUniformMatrix4fv(int location, int count, unsigned char transpose, NumericMatrix mat) {
   glm::mat4 value = asMat4(mat);
+  uniformsTouched();
   glUniformMatrix4fv(location, count, transpose,  & value[0][0]);
   
 }
@@ -1728,7 +1906,7 @@ void myGlUniformMatrix4fv(int location, int count, unsigned char transpose, Nume
 // [[Rcpp::export(name = 'glUseProgram')]]
 void myGlUseProgram(unsigned int program) {
   
-  glUseProgram(program);
+  cachedUseProgram(program);
   
 }
 
@@ -1804,6 +1982,14 @@ void myGlVertexAttrib4fv(unsigned int index, std::vector<float> v) {
   
 }
 
+//' @export
+// [[Rcpp::export(name = 'glVertexAttribDivisor')]]
+void myGlVertexAttribDivisor(unsigned int index, unsigned int divisor) {
+  
+  vertexAttribDivisor(index, divisor);
+  
+}
+
 //' @export
 // [[Rcpp::export(name = 'glVertexAttribPointer')]]
 void myGlVertexAttribPointer(unsigned int index, int size, unsigned int type, unsigned char normalized, int stride, int pointer) {
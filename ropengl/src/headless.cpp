@@ -0,0 +1,243 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <string>
+#ifdef ROPENGL_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#ifdef ROPENGL_OSMESA
+#include <GL/osmesa.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "headless.h"
+#include "ropengl.h"
+#include "state.h"
+using namespace Rcpp;
+
+/*
+ * Headless rendering for machines without a display. The context comes from EGL, on
+ * Mesa's surfaceless platform when the driver offers it and the default display
+ * otherwise, or from OSMesa. Each backend is only built when the package is installed
+ * with ROPENGL_EGL or ROPENGL_OSMESA set, so window-only builds need neither. Either
+ * way nothing is drawn to a window: a framebuffer object of the requested size, with
+ * RGBA8 colour and depth / stencil renderbuffers, takes the place of the default
+ * framebuffer, and glBindFramebuffer(target, 0) binds it. flip() only flushes.
+ */
+static GLuint framebuffer = 0;
+static GLuint renderbuffers[2] = { 0, 0 };
+static int framebufferWidth = 0;
+static int framebufferHeight = 0;
+
+#ifdef ROPENGL_EGL
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+#endif
+#ifdef ROPENGL_OSMESA
+static OSMesaContext osmesaContext = NULL;
+static unsigned char * osmesaBuffer = NULL;
+#endif
+
+GLuint headlessFramebuffer() {
+  return framebuffer;
+}
+
+void bindFramebuffer(GLenum target, GLuint name) {
+  cachedBindFramebuffer(target, name == 0 ? framebuffer : name);
+}
+
+void defaultFramebufferSize(int * width, int * height) {
+  if(window != NULL) {
+    glfwGetFramebufferSize(window, width, height);
+  }
+  else {
+    *width = framebufferWidth;
+    *height = framebufferHeight;
+  }
+}
+
+#ifdef ROPENGL_EGL
+static EGLDisplay eglOpenDisplay() {
+  const char * extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  if(extensions != NULL && strstr(extensions, "EGL_MESA_platform_surfaceless") != NULL) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if(getPlatformDisplay != NULL) {
+      EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+      if(display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) {
+        return display;
+      }
+    }
+  }
+  EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if(display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) {
+    return display;
+  }
+  return EGL_NO_DISPLAY;
+}
+
+static std::string eglStart() {
+  eglDisplay = eglOpenDisplay();
+  if(eglDisplay == EGL_NO_DISPLAY) {
+    return "no EGL display";
+  }
+  const EGLint configAttributes[] = {
+    EGL_SURFACE_TYPE, 0,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_NONE
+  };
+  /* The same 3.0 context createWindow asks GLFW for */
+  const EGLint contextAttributes[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 3,
+    EGL_CONTEXT_MINOR_VERSION, 0,
+    EGL_NONE
+  };
+  EGLConfig config;
+  EGLint configs = 0;
+  if(!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configs) || configs == 0) {
+    eglTerminate(eglDisplay);
+    eglDisplay = EGL_NO_DISPLAY;
+    return "no EGL config for desktop OpenGL";
+  }
+  eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+  if(eglContext == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+    if(eglContext != EGL_NO_CONTEXT) {
+      eglDestroyContext(eglDisplay, eglContext);
+      eglContext = EGL_NO_CONTEXT;
+    }
+    eglTerminate(eglDisplay);
+    eglDisplay = EGL_NO_DISPLAY;
+    return "EGL context without a surface could not be made current";
+  }
+  gladLoadGLLoader((GLADloadproc) eglGetProcAddress);
+  return "";
+}
+#endif
+
+#ifdef ROPENGL_OSMESA
+static std::string osmesaStart(int width, int height) {
+  osmesaContext = OSMesaCreateContextExt(OSMESA_RGBA, 24, 8, 0, NULL);
+  if(osmesaContext == NULL) {
+    return "OSMesa context could not be created";
+  }
+  /* OSMesa needs a colour buffer to be current, even though drawing goes to the FBO */
+  osmesaBuffer = (unsigned char *) malloc((size_t) width * height * 4);
+  if(osmesaBuffer == NULL || !OSMesaMakeCurrent(osmesaContext, osmesaBuffer, GL_UNSIGNED_BYTE, width, height)) {
+    OSMesaDestroyContext(osmesaContext);
+    osmesaContext = NULL;
+    free(osmesaBuffer);
+    osmesaBuffer = NULL;
+    return "OSMesa context could not be made current";
+  }
+  gladLoadGLLoader((GLADloadproc) OSMesaGetProcAddress);
+  return "";
+}
+#endif
+
+static bool createFramebuffer(int width, int height) {
+  glGenRenderbuffers(2, renderbuffers);
+  cachedBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  cachedBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  cachedBindRenderbuffer(GL_RENDERBUFFER, 0);
+  glGenFramebuffers(1, &framebuffer);
+  /* through the cache, so saved bindings come back as this FBO rather than a real 0 */
+  cachedBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+  glViewport(0, 0, width, height);
+  framebufferWidth = width;
+  framebufferHeight = height;
+  return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+//' Destroy the offscreen context
+//' @export
+// [[Rcpp::export]]
+void destroyHeadlessContext() {
+  if(framebuffer != 0) {
+    cachedDeleteFramebuffers(1, &framebuffer);
+    cachedDeleteRenderbuffers(2, renderbuffers);
+    framebuffer = 0;
+    framebufferWidth = framebufferHeight = 0;
+  }
+#ifdef ROPENGL_EGL
+  if(eglContext != EGL_NO_CONTEXT) {
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(eglDisplay, eglContext);
+    eglTerminate(eglDisplay);
+    eglContext = EGL_NO_CONTEXT;
+    eglDisplay = EGL_NO_DISPLAY;
+  }
+#endif
+#ifdef ROPENGL_OSMESA
+  if(osmesaContext != NULL) {
+    OSMesaDestroyContext(osmesaContext);
+    free(osmesaBuffer);
+    osmesaContext = NULL;
+    osmesaBuffer = NULL;
+  }
+#endif
+}
+
+//' Create an offscreen context without a window
+//'
+//' For servers without a display. Rendering goes to a framebuffer object of the given
+//' size that stands in for the window: glBindFramebuffer(GL_FRAMEBUFFER, 0) binds it,
+//' glReadPixels reads it and flip() flushes instead of swapping. Window and input
+//' functions are not available. Both backends are optional so window-only installs need
+//' neither library: EGL is built with ROPENGL_EGL and OSMesa with ROPENGL_OSMESA set in
+//' the environment at install time. EGL is tried first when both are there.
+//' @param width framebuffer width
+//' @param height framebuffer height
+//' @param backend "egl", "osmesa" or "auto" for the first one that works
+//' @return the backend used
+//' @export
+// [[Rcpp::export]]
+std::string createHeadlessContext(int width, int height, std::string backend = "auto") {
+  if(backend != "auto" && backend != "egl" && backend != "osmesa") {
+    stop("backend must be \"auto\", \"egl\" or \"osmesa\"");
+  }
+  if(width <= 0 || height <= 0) {
+    stop("width and height must be positive");
+  }
+  if(framebuffer != 0) {
+    stop("a headless context already exists");
+  }
+  std::string errors;
+  std::string used;
+#ifdef ROPENGL_EGL
+  if(used.empty() && backend != "osmesa") {
+    std::string error = eglStart();
+    if(error.empty()) {
+      used = "egl";
+    }
+    else {
+      errors += "EGL: " + error + "; ";
+    }
+  }
+#endif
+#ifdef ROPENGL_OSMESA
+  if(used.empty() && backend != "egl") {
+    std::string error = osmesaStart(width, height);
+    if(error.empty()) {
+      used = "osmesa";
+    }
+    else {
+      errors += "OSMesa: " + error + "; ";
+    }
+  }
+#endif
+  if(used.empty()) {
+    stop(errors.empty() ? "no headless backend in this build" : errors.substr(0, errors.size() - 2));
+  }
+  window = NULL;
+  /* getFlag and %#% look constants up here just as with a window */
+  initFlagMap();
+  cachedReset();
+  if(!createFramebuffer(width, height)) {
+    destroyHeadlessContext();
+    stop("offscreen framebuffer is incomplete");
+  }
+  return used;
+}
@@ -0,0 +1,17 @@
+#ifndef ROPENGL_HEADLESS_H
+#define ROPENGL_HEADLESS_H
+
+#include <glad/glad.h>
+
+/*
+ * Offscreen contexts without a window, see headless.cpp. headlessFramebuffer is the
+ * framebuffer object that stands in for the default framebuffer, 0 when rendering to a
+ * window. defaultFramebufferSize is the size of whichever of the two is in use.
+ * bindFramebuffer is what every glBindFramebuffer entry point goes through so that
+ * binding 0 lands on that framebuffer object.
+ */
+GLuint headlessFramebuffer();
+void bindFramebuffer(GLenum target, GLuint framebuffer);
+void defaultFramebufferSize(int * width, int * height);
+
+#endif
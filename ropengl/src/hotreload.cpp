@@ -0,0 +1,339 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include "programcache.h"
+#include "programs.h"
+#include "shaders.h"
+using namespace Rcpp;
+
+/*
+ * Shader hot reload. watchProgram builds a program from shader files and remembers
+ * every file its stages were preprocessed from. On Linux a background thread watches
+ * the directories of those files with inotify and queues the names that were written
+ * or replaced; elsewhere reloadChangedPrograms compares mtimes and sizes itself, at
+ * most a few times per second. Either way the rebuild happens on the GL thread, from
+ * flip() or reloadShaders().
+ *
+ * A rebuilt program is first linked into a scratch program. Only when that succeeds
+ * are the new shaders linked into the original program object, so the GL name held by
+ * R, command buffers and fast calls stays the same and a broken edit leaves the
+ * running program untouched. Relinking resets uniform values and may move uniform
+ * locations; the reflection tables used by setUniform are rebuilt.
+ */
+struct WatchedStage {
+  GLenum type;
+  std::string path;
+};
+
+struct WatchedFile {
+  double mtime;
+  double size;
+};
+
+struct WatchedProgram {
+  std::vector<WatchedStage> stages;
+  std::vector<std::string> includeDirs;
+  std::vector<std::string> defines;
+  std::map<std::string, WatchedFile> files;
+};
+
+static std::map<GLuint, WatchedProgram> watched;
+
+static std::mutex changedMutex;
+static std::set<std::string> changedFiles;
+static std::atomic<bool> anyChanged(false);
+
+static WatchedFile statFile(const std::string & path) {
+  WatchedFile file = { -1, -1 };
+  struct stat st;
+  if(stat(path.c_str(), &st) == 0) {
+    file.mtime = (double) st.st_mtime;
+    file.size = (double) st.st_size;
+  }
+  return file;
+}
+
+static std::string directoryOf(const std::string & path) {
+  size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+}
+
+#ifdef __linux__
+
+static int inotifyFd = -1;
+/* Several spellings of one directory share a watch descriptor */
+static std::map<int, std::set<std::string> > watchDirs;
+static std::map<std::string, int> dirWatches;
+static std::thread watcher;
+static std::atomic<bool> stopping(false);
+
+static void watchLoop() {
+  std::vector<char> buffer(64 * 1024);
+  while(!stopping) {
+    struct pollfd pfd = { inotifyFd, POLLIN, 0 };
+    if(poll(&pfd, 1, 100) <= 0) {
+      continue;
+    }
+    ssize_t n = read(inotifyFd, &buffer[0], buffer.size());
+    std::lock_guard<std::mutex> lock(changedMutex);
+    for (ssize_t offset = 0; offset < n; ) {
+      const struct inotify_event * event = (const struct inotify_event *) &buffer[offset];
+      std::map<int, std::set<std::string> >::iterator dirs = watchDirs.find(event->wd);
+      if(dirs != watchDirs.end() && event->len > 0) {
+        for (std::set<std::string>::iterator dir = dirs->second.begin(); dir != dirs->second.end(); ++dir) {
+          changedFiles.insert(*dir + event->name);
+        }
+        anyChanged = true;
+      }
+      offset += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+
+/* Stops the watcher thread when the package library is unloaded */
+static struct InotifyWatcher {
+  ~InotifyWatcher() {
+    stopping = true;
+    if(watcher.joinable()) {
+      watcher.join();
+    }
+    if(inotifyFd >= 0) {
+      close(inotifyFd);
+    }
+  }
+} inotifyWatcher;
+
+static void watchDirectory(const std::string & dir) {
+  std::lock_guard<std::mutex> lock(changedMutex);
+  if(dirWatches.count(dir)) {
+    return;
+  }
+  if(inotifyFd < 0) {
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(inotifyFd < 0) {
+      stop("inotify is not available");
+    }
+    watcher = std::thread(watchLoop);
+  }
+  int wd = inotify_add_watch(inotifyFd, dir.empty() ? "." : dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  if(wd < 0) {
+    stop(dir + ": cannot be watched");
+  }
+  watchDirs[wd].insert(dir);
+  dirWatches[dir] = wd;
+}
+
+#else
+
+static double lastScan = 0;
+
+static double seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void watchDirectory(const std::string & dir) {
+}
+
+/* Without inotify, look for changed stat data at most every quarter second */
+static void scanFiles() {
+  double now = seconds();
+  if(now - lastScan < 0.25) {
+    return;
+  }
+  lastScan = now;
+  std::lock_guard<std::mutex> lock(changedMutex);
+  for (std::map<GLuint, WatchedProgram>::iterator p = watched.begin(); p != watched.end(); ++p) {
+    for (std::map<std::string, WatchedFile>::iterator f = p->second.files.begin(); f != p->second.files.end(); ++f) {
+      WatchedFile now = statFile(f->first);
+      if(now.mtime != f->second.mtime || now.size != f->second.size) {
+        changedFiles.insert(f->first);
+        anyChanged = true;
+      }
+    }
+  }
+}
+
+#endif
+
+/* Preprocess and compile every stage; the stage files are recorded in `files` */
+static std::vector<GLuint> compileWatched(WatchedProgram & program, bool reload, std::map<std::string, WatchedFile> & files) {
+  std::vector<GLuint> shaders;
+  try {
+    for (size_t i = 0; i < program.stages.size(); i++) {
+      std::vector<std::string> stageFiles;
+      ProgramStage stage;
+      stage.type = program.stages[i].type;
+      stage.source = withDefines(preprocessShaderFile(program.stages[i].path, program.includeDirs, &stageFiles, reload), program.defines);
+      for (size_t f = 0; f < stageFiles.size(); f++) {
+        files[stageFiles[f]] = statFile(stageFiles[f]);
+      }
+      shaders.push_back(compileShaderStage(stage));
+    }
+  }
+  catch(...) {
+    for (size_t i = 0; i < shaders.size(); i++) {
+      forgetShaderSource(shaders[i]);
+      glDeleteShader(shaders[i]);
+    }
+    throw;
+  }
+  return shaders;
+}
+
+static std::string linkWith(GLuint program, const std::vector<GLuint> & shaders) {
+  for (size_t i = 0; i < shaders.size(); i++) {
+    glAttachShader(program, shaders[i]);
+  }
+  glLinkProgram(program);
+  for (size_t i = 0; i < shaders.size(); i++) {
+    glDetachShader(program, shaders[i]);
+  }
+  return linkError(program);
+}
+
+static void deleteShaders(const std::vector<GLuint> & shaders) {
+  for (size_t i = 0; i < shaders.size(); i++) {
+    forgetShaderSource(shaders[i]);
+    glDeleteShader(shaders[i]);
+  }
+}
+
+/* Rebuild one watched program, leaving it untouched and returning why on failure */
+static std::string reloadProgram(GLuint program, WatchedProgram & source) {
+  std::map<std::string, WatchedFile> files;
+  std::vector<GLuint> shaders;
+  try {
+    shaders = compileWatched(source, true, files);
+  }
+  catch(std::exception & e) {
+    return e.what();
+  }
+  GLuint scratch = glCreateProgram();
+  std::string error = linkWith(scratch, shaders);
+  glDeleteProgram(scratch);
+  if(error.empty()) {
+    error = linkWith(program, shaders);
+  }
+  deleteShaders(shaders);
+  if(!error.empty()) {
+    return error;
+  }
+  reflectProgram(program);
+  source.files = files;
+  for (std::map<std::string, WatchedFile>::iterator f = files.begin(); f != files.end(); ++f) {
+    watchDirectory(directoryOf(f->first));
+  }
+  return "";
+}
+
+int reloadChangedPrograms() {
+  if(watched.empty()) {
+    return 0;
+  }
+#ifndef __linux__
+  scanFiles();
+#endif
+  if(!anyChanged) {
+    return 0;
+  }
+  std::set<std::string> changed;
+  {
+    std::lock_guard<std::mutex> lock(changedMutex);
+    changed.swap(changedFiles);
+    anyChanged = false;
+  }
+  int reloaded = 0;
+  for (std::map<GLuint, WatchedProgram>::iterator p = watched.begin(); p != watched.end(); ++p) {
+    bool affected = false;
+    for (std::set<std::string>::iterator f = changed.begin(); f != changed.end() && !affected; ++f) {
+      affected = p->second.files.count(*f) > 0;
+    }
+    if(!affected) {
+      continue;
+    }
+    /* A failed reload waits for the next edit rather than retrying every scan */
+    for (std::set<std::string>::iterator f = changed.begin(); f != changed.end(); ++f) {
+      if(p->second.files.count(*f)) {
+        p->second.files[*f] = statFile(*f);
+      }
+    }
+    std::string error = reloadProgram(p->first, p->second);
+    if(error.empty()) {
+      reloaded++;
+    }
+    else {
+      warning("program " + std::to_string(p->first) + " not reloaded: " + error);
+    }
+  }
+  return reloaded;
+}
+
+void unwatchProgram(GLuint program) {
+  watched.erase(program);
+}
+
+//' Build a program from shader files and reload it when they change
+//'
+//' The files (and everything they #include) are watched; flip() or reloadShaders()
+//' relink the program in place after an edit. The program keeps its GL name; a failed
+//' compile or link only produces a warning and leaves the previous version running.
+//' Uniform values are reset by a reload, so set them every frame or through setUniform.
+//' @param vertex vertex shader file
+//' @param fragment fragment shader file
+//' @param geometry optional geometry shader file
+//' @param includeDirs directories searched for included files
+//' @param defines "NAME" or "NAME=VALUE" strings defined after the #version line
+//' @return GL program name
+//' @export
+// [[Rcpp::export]]
+unsigned int watchProgram(std::string vertex, std::string fragment, std::string geometry = "", CharacterVector includeDirs = CharacterVector::create(), CharacterVector defines = CharacterVector::create()) {
+  WatchedProgram source;
+  WatchedStage stage = { GL_VERTEX_SHADER, vertex };
+  source.stages.push_back(stage);
+  if(!geometry.empty()) {
+    stage.type = GL_GEOMETRY_SHADER;
+    stage.path = geometry;
+    source.stages.push_back(stage);
+  }
+  stage.type = GL_FRAGMENT_SHADER;
+  stage.path = fragment;
+  source.stages.push_back(stage);
+  source.includeDirs = as<std::vector<std::string> >(includeDirs);
+  source.defines = as<std::vector<std::string> >(defines);
+  std::vector<GLuint> shaders = compileWatched(source, false, source.files);
+  GLuint program = glCreateProgram();
+  std::string error = linkWith(program, shaders);
+  deleteShaders(shaders);
+  if(!error.empty()) {
+    glDeleteProgram(program);
+    stop(error);
+  }
+  reflectProgram(program);
+  for (std::map<std::string, WatchedFile>::iterator f = source.files.begin(); f != source.files.end(); ++f) {
+    watchDirectory(directoryOf(f->first));
+  }
+  watched[program] = source;
+  return program;
+}
+
+//' Reload watched programs whose files changed
+//'
+//' flip() does this every frame.
+//' @return number of programs relinked
+//' @export
+// [[Rcpp::export]]
+int reloadShaders() {
+  return reloadChangedPrograms();
+}
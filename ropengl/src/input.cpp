@@ -0,0 +1,157 @@
+#include <Rcpp.h>
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <bitset>
+#include "input.h"
+using namespace Rcpp;
+
+/*
+ * Input event queue. GLFW callbacks append to a single-producer / single-consumer ring
+ * of fixed size, so nothing between two drains is overwritten the way the last-value
+ * mouse globals are. The producer only writes `head` and the consumer only `tail`;
+ * neither side takes a lock. When the ring is full new events are dropped and counted
+ * rather than overwriting ones R has not seen.
+ *
+ * Key events also keep a bitset of the keys held down, plus the keys pressed and
+ * released since keyboardState last looked at them, so a whole keyboard snapshot and
+ * its edges need no glfwGetKey calls.
+ */
+struct InputEvent {
+  double time;
+  int type;
+  int code;
+  int action;
+  int mods;
+  double x;
+  double y;
+};
+
+static const size_t queueSize = 8192;
+static InputEvent queue[queueSize];
+static std::atomic<size_t> head(0);
+static std::atomic<size_t> tail(0);
+static std::atomic<size_t> dropped(0);
+
+void recordInputEvent(InputEventType type, int code, int action, int mods, double x, double y) {
+  size_t h = head.load(std::memory_order_relaxed);
+  if(h - tail.load(std::memory_order_acquire) == queueSize) {
+    dropped++;
+    return;
+  }
+  InputEvent & event = queue[h % queueSize];
+  event.time = glfwGetTime();
+  event.type = type;
+  event.code = code;
+  event.action = action;
+  event.mods = mods;
+  event.x = x;
+  event.y = y;
+  head.store(h + 1, std::memory_order_release);
+}
+
+static std::bitset<GLFW_KEY_LAST + 1> keysDown;
+static std::bitset<GLFW_KEY_LAST + 1> keysPressed;
+static std::bitset<GLFW_KEY_LAST + 1> keysReleased;
+
+static void keyCallback(GLFWwindow * window, int key, int scancode, int action, int mods) {
+  if(key >= 0 && key <= GLFW_KEY_LAST) {
+    if(action == GLFW_PRESS) {
+      keysDown.set(key);
+      keysPressed.set(key);
+    }
+    else if(action == GLFW_RELEASE) {
+      keysDown.reset(key);
+      keysReleased.set(key);
+    }
+  }
+  recordInputEvent(INPUT_KEY, key, action, mods, scancode, 0);
+}
+
+static void charCallback(GLFWwindow * window, unsigned int codepoint) {
+  recordInputEvent(INPUT_CHAR, codepoint, 0, 0, 0, 0);
+}
+
+static void resizeCallback(GLFWwindow * window, int width, int height) {
+  recordInputEvent(INPUT_RESIZE, 0, 0, 0, width, height);
+}
+
+void installInputCallbacks(GLFWwindow * window) {
+  glfwSetKeyCallback(window, keyCallback);
+  glfwSetCharCallback(window, charCallback);
+  glfwSetFramebufferSizeCallback(window, resizeCallback);
+}
+
+//' Take every input event recorded since the last call
+//'
+//' Key, char, mouse button, scroll, cursor and framebuffer resize events are queued as
+//' they arrive during flip() or glfwPollEvents(), with their glfwGetTime() timestamp.
+//' code is the GLFW key, mouse button or Unicode code point; action is GLFW_PRESS (1),
+//' GLFW_RELEASE (0) or GLFW_REPEAT (2). x and y hold the scroll offsets, cursor
+//' position or framebuffer size; for keys x is the scancode.
+//' @return data.frame with time, type ("key", "char", "button", "scroll", "cursor" or
+//' "resize"), code, action, mods, x and y, oldest first. The "dropped" attribute counts
+//' events lost to a full queue since the previous call.
+//' @export
+// [[Rcpp::export]]
+DataFrame drainInputEvents() {
+  static const char * names[] = { "key", "char", "button", "scroll", "cursor", "resize" };
+  size_t t = tail.load(std::memory_order_relaxed);
+  size_t h = head.load(std::memory_order_acquire);
+  int n = h - t;
+  NumericVector time(n), x(n), y(n);
+  CharacterVector type(n);
+  IntegerVector code(n), action(n), mods(n);
+  for (int i = 0; i < n; i++) {
+    const InputEvent & event = queue[(t + i) % queueSize];
+    time[i] = event.time;
+    type[i] = names[event.type];
+    code[i] = event.code;
+    action[i] = event.action;
+    mods[i] = event.mods;
+    x[i] = event.x;
+    y[i] = event.y;
+  }
+  tail.store(h, std::memory_order_release);
+  DataFrame out = DataFrame::create(_["time"] = time, _["type"] = type, _["code"] = code,
+                                    _["action"] = action, _["mods"] = mods, _["x"] = x, _["y"] = y,
+                                    _["stringsAsFactors"] = false);
+  out.attr("dropped") = (double) dropped.exchange(0);
+  return out;
+}
+
+//' Snapshot of the whole keyboard
+//'
+//' The state is kept from key events, so one call replaces a getKeyByName per key.
+//' pressed and released are the edges since the previous call that reported the key: a
+//' key tapped between two calls counts as both even though it is not down in either
+//' snapshot. Only the edges of the reported codes are consumed.
+//' @param codes key codes from keyCodes() to report, every code when empty
+//' @return list of logical vectors down, pressed and released, one element per code;
+//' without codes element code + 1 belongs to key code
+//' @export
+// [[Rcpp::export]]
+List keyboardState(IntegerVector codes = IntegerVector::create()) {
+  bool all = codes.size() == 0;
+  int n = all ? GLFW_KEY_LAST + 1 : codes.size();
+  LogicalVector down(n), pressed(n), released(n);
+  for (int i = 0; i < n; i++) {
+    int code = all ? i : codes[i];
+    if(code < 0 || code > GLFW_KEY_LAST) {
+      stop("invalid key code " + std::to_string(code));
+    }
+    down[i] = keysDown[code];
+    pressed[i] = keysPressed[code];
+    released[i] = keysReleased[code];
+  }
+  if(all) {
+    keysPressed.reset();
+    keysReleased.reset();
+  }
+  else {
+    for (int i = 0; i < n; i++) {
+      keysPressed.reset(codes[i]);
+      keysReleased.reset(codes[i]);
+    }
+  }
+  return List::create(_["down"] = down, _["pressed"] = pressed, _["released"] = released);
+}
@@ -0,0 +1,23 @@
+#ifndef ROPENGL_INPUT_H
+#define ROPENGL_INPUT_H
+
+#include <GLFW/glfw3.h>
+
+/*
+ * Window input events, see input.cpp. The GLFW callbacks record every event with its
+ * time into a fixed ring that drainInputEvents empties; installInputCallbacks sets the
+ * key, char and resize callbacks, the mouse callbacks in gl.cpp record their own.
+ */
+enum InputEventType {
+  INPUT_KEY,
+  INPUT_CHAR,
+  INPUT_BUTTON,
+  INPUT_SCROLL,
+  INPUT_CURSOR,
+  INPUT_RESIZE
+};
+
+void recordInputEvent(InputEventType type, int code, int action, int mods, double x, double y);
+void installInputCallbacks(GLFWwindow * window);
+
+#endif
@@ -0,0 +1,313 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <math.h>
+#include <stdint.h>
+#include "simd.h"
+#include "state.h"
+#include "instances.h"
+using namespace Rcpp;
+
+/*
+ * Model matrices for many instances at once, M = T * R * S, written as 16 column-major
+ * floats per instance straight into a mapped GL buffer. Inputs are R matrices or
+ * data.frames, whose columns are already structure-of-arrays. Each chunk is first
+ * narrowed to float SoA (trig and quaternion normalisation are scalar), then the
+ * rotation/scale basis is built four instances at a time and transposed into place.
+ */
+struct InstanceJob {
+  const double * pos[3];
+  const double * rot[4];
+  int rotColumns;
+  const double * scale[3];
+  int scaleColumns;
+  float * out;
+};
+
+static const int INSTANCE_CHUNK = 256;
+
+/* Columns of R = Rz * Ry * Rx from the sines and cosines of the three angles */
+template <typename T> static inline void eulerBasis(const T * s, const T * c, T * b) {
+  b[0] = c[2] * c[1];
+  b[1] = s[2] * c[1];
+  b[2] = T(0.0f) - s[1];
+  b[3] = c[2] * s[1] * s[0] - s[2] * c[0];
+  b[4] = s[2] * s[1] * s[0] + c[2] * c[0];
+  b[5] = c[1] * s[0];
+  b[6] = c[2] * s[1] * c[0] + s[2] * s[0];
+  b[7] = s[2] * s[1] * c[0] - c[2] * s[0];
+  b[8] = c[1] * c[0];
+}
+
+/* Columns of the rotation for a unit quaternion q = (w, x, y, z) */
+template <typename T> static inline void quatBasis(const T * q, T * b) {
+  T one(1.0f), two(2.0f);
+  b[0] = one - two * (q[2] * q[2] + q[3] * q[3]);
+  b[1] = two * (q[1] * q[2] + q[0] * q[3]);
+  b[2] = two * (q[1] * q[3] - q[0] * q[2]);
+  b[3] = two * (q[1] * q[2] - q[0] * q[3]);
+  b[4] = one - two * (q[1] * q[1] + q[3] * q[3]);
+  b[5] = two * (q[2] * q[3] + q[0] * q[1]);
+  b[6] = two * (q[1] * q[3] + q[0] * q[2]);
+  b[7] = two * (q[2] * q[3] - q[0] * q[1]);
+  b[8] = one - two * (q[1] * q[1] + q[2] * q[2]);
+}
+
+#if defined(__SSE2__)
+struct F4 {
+  __m128 v;
+  F4() {}
+  F4(__m128 x) : v(x) {}
+  explicit F4(float f) : v(_mm_set1_ps(f)) {}
+};
+
+static inline F4 operator+(F4 a, F4 b) { return _mm_add_ps(a.v, b.v); }
+static inline F4 operator-(F4 a, F4 b) { return _mm_sub_ps(a.v, b.v); }
+static inline F4 operator*(F4 a, F4 b) { return _mm_mul_ps(a.v, b.v); }
+
+/* Store one column (x, y, z, w registers across four instances) into each instance */
+static inline void storeColumn(float * out, F4 x, F4 y, F4 z, F4 w, bool stream) {
+  _MM_TRANSPOSE4_PS(x.v, y.v, z.v, w.v);
+  if(stream) {
+    _mm_stream_ps(out, x.v);
+    _mm_stream_ps(out + 16, y.v);
+    _mm_stream_ps(out + 32, z.v);
+    _mm_stream_ps(out + 48, w.v);
+  }
+  else {
+    _mm_storeu_ps(out, x.v);
+    _mm_storeu_ps(out + 16, y.v);
+    _mm_storeu_ps(out + 32, z.v);
+    _mm_storeu_ps(out + 48, w.v);
+  }
+}
+#endif
+
+static void buildInstances(const InstanceJob & job, R_xlen_t begin, R_xlen_t end) {
+  /* SoA scratch: rotation inputs (sines then cosines, or a quaternion), scale, position */
+  float rot[6][INSTANCE_CHUNK], scl[3][INSTANCE_CHUNK], pos[3][INSTANCE_CHUNK];
+  bool euler = job.rotColumns == 3;
+#if defined(__SSE2__)
+  /* mapped buffers are usually write-combined, so bypass the cache when aligned */
+  bool stream = ((uintptr_t) job.out & 15) == 0;
+#endif
+  for (R_xlen_t base = begin; base < end; base += INSTANCE_CHUNK) {
+    int m = (int) std::min((R_xlen_t) INSTANCE_CHUNK, end - base);
+    for (int k = 0; k < 3; k++) {
+      narrowToFloat(job.pos[k] + base, pos[k], m);
+      if(job.scaleColumns == 0) {
+        std::fill(scl[k], scl[k] + m, 1.0f);
+      }
+      else {
+        narrowToFloat(job.scale[job.scaleColumns == 3 ? k : 0] + base, scl[k], m);
+      }
+    }
+    for (int i = 0; i < m; i++) {
+      R_xlen_t n = base + i;
+      if(euler) {
+        for (int k = 0; k < 3; k++) {
+          float a = (float) job.rot[k][n];
+          rot[k][i] = sinf(a);
+          rot[k + 3][i] = cosf(a);
+        }
+      }
+      else if(job.rotColumns == 4) {
+        float q[4], len = 0;
+        for (int k = 0; k < 4; k++) {
+          q[k] = (float) job.rot[k][n];
+          len += q[k] * q[k];
+        }
+        len = len > 0 ? 1.0f / sqrtf(len) : 0.0f;
+        for (int k = 0; k < 4; k++) {
+          rot[k][i] = q[k] * len;
+        }
+      }
+      else {
+        rot[0][i] = 1.0f;
+        rot[1][i] = rot[2][i] = rot[3][i] = 0.0f;
+      }
+    }
+    float * out = job.out + base * 16;
+    int i = 0;
+#if defined(__SSE2__)
+    F4 zero(0.0f), one(1.0f);
+    for (; i + 4 <= m; i += 4) {
+      F4 r[6], b[9];
+      for (int k = 0; k < 6; k++) {
+        r[k] = _mm_loadu_ps(rot[k] + i);
+      }
+      if(euler) {
+        eulerBasis(r, r + 3, b);
+      }
+      else {
+        quatBasis(r, b);
+      }
+      for (int c = 0; c < 3; c++) {
+        F4 s = _mm_loadu_ps(scl[c] + i);
+        storeColumn(out + i * 16 + c * 4, b[c * 3] * s, b[c * 3 + 1] * s, b[c * 3 + 2] * s, zero, stream);
+      }
+      storeColumn(out + i * 16 + 12, _mm_loadu_ps(pos[0] + i), _mm_loadu_ps(pos[1] + i),
+                  _mm_loadu_ps(pos[2] + i), one, stream);
+    }
+#endif
+    for (; i < m; i++) {
+      float r[6], b[9];
+      for (int k = 0; k < 6; k++) {
+        r[k] = rot[k][i];
+      }
+      if(euler) {
+        eulerBasis(r, r + 3, b);
+      }
+      else {
+        quatBasis(r, b);
+      }
+      float * o = out + i * 16;
+      for (int c = 0; c < 3; c++) {
+        o[c * 4] = b[c * 3] * scl[c][i];
+        o[c * 4 + 1] = b[c * 3 + 1] * scl[c][i];
+        o[c * 4 + 2] = b[c * 3 + 2] * scl[c][i];
+        o[c * 4 + 3] = 0.0f;
+      }
+      o[12] = pos[0][i];
+      o[13] = pos[1][i];
+      o[14] = pos[2][i];
+      o[15] = 1.0f;
+    }
+  }
+#if defined(__SSE2__)
+  _mm_sfence();
+#endif
+}
+
+/* Column pointers of a double matrix or a list / data.frame of double vectors */
+static int instanceColumns(SEXP x, R_xlen_t n, const char * what, const double ** cols, int maxColumns) {
+  int k = 0;
+  if(Rf_isNull(x)) {
+    return 0;
+  }
+  if(TYPEOF(x) == VECSXP) {
+    k = Rf_length(x);
+    for (int j = 0; j < k && j < maxColumns; j++) {
+      SEXP col = VECTOR_ELT(x, j);
+      if(TYPEOF(col) != REALSXP || XLENGTH(col) != n) {
+        stop(std::string(what) + " columns must be double vectors with one value per instance");
+      }
+      cols[j] = REAL(col);
+    }
+  }
+  else if(TYPEOF(x) == REALSXP) {
+    k = Rf_isMatrix(x) ? Rf_ncols(x) : 1;
+    if(XLENGTH(x) != n * k) {
+      stop(std::string(what) + " must have one row per instance");
+    }
+    for (int j = 0; j < k && j < maxColumns; j++) {
+      cols[j] = REAL(x) + j * n;
+    }
+  }
+  else {
+    stop(std::string(what) + " must be a double matrix or a data.frame");
+  }
+  return k;
+}
+
+//' Build instance model matrices into a GL buffer
+//'
+//' Computes translate(position) * rotate * scale for every instance and writes the
+//' matrices (16 floats each, column-major) into buffer, ready for four vec4 instanced
+//' attributes. Rotation is applied X, then Y, then Z for Euler angles.
+//' @param buffer GL buffer name
+//' @param positions n x 3 double matrix or data.frame of x, y, z
+//' @param rotations NULL, n x 3 Euler angles in radians or n x 4 quaternions (w, x, y, z)
+//' @param scales NULL, one uniform scale per instance or n x 3
+//' @param offset byte offset of the first matrix in the buffer
+//' @param allocate re-specify the buffer store to exactly fit the matrices first
+//' @param threads worker threads, 0 picks one per core for large batches
+//' @return number of instances written
+//' @export
+// [[Rcpp::export]]
+double instanceMatrices(unsigned int buffer, SEXP positions, SEXP rotations = R_NilValue, SEXP scales = R_NilValue,
+                        double offset = 0, bool allocate = true, int threads = 0) {
+  InstanceJob job;
+  R_xlen_t n = 0;
+  if(Rf_isMatrix(positions)) {
+    n = Rf_nrows(positions);
+  }
+  else if(TYPEOF(positions) == VECSXP && Rf_length(positions) > 0) {
+    n = Rf_xlength(VECTOR_ELT(positions, 0));
+  }
+  if(instanceColumns(positions, n, "positions", job.pos, 3) != 3) {
+    stop("positions need 3 columns");
+  }
+  job.rotColumns = instanceColumns(rotations, n, "rotations", job.rot, 4);
+  if(job.rotColumns != 0 && job.rotColumns != 3 && job.rotColumns != 4) {
+    stop("rotations need 3 columns (Euler angles) or 4 (quaternions)");
+  }
+  job.scaleColumns = instanceColumns(scales, n, "scales", job.scale, 3);
+  if(job.scaleColumns != 0 && job.scaleColumns != 1 && job.scaleColumns != 3) {
+    stop("scales need 1 or 3 columns");
+  }
+  if(n == 0) {
+    return 0;
+  }
+  GLsizeiptr bytes = n * 16 * sizeof(float);
+  cachedBindBuffer(GL_ARRAY_BUFFER, buffer);
+  if(allocate) {
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) offset + bytes, NULL, GL_DYNAMIC_DRAW);
+  }
+  job.out = (float *) glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr) offset, bytes,
+                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+  if(job.out == NULL) {
+    stop("glMapBufferRange failed, is the buffer large enough?");
+  }
+  if(threads <= 0) {
+    threads = n < 16384 ? 1 : std::min(8, (int) std::thread::hardware_concurrency());
+  }
+  threads = std::max(1, (int) std::min((R_xlen_t) threads, n / 1024 + 1));
+  if(threads == 1) {
+    buildInstances(job, 0, n);
+  }
+  else {
+    std::vector<std::thread> workers;
+    R_xlen_t step = (n / threads + 3) & ~(R_xlen_t) 3;
+    for (R_xlen_t begin = 0; begin < n; begin += step) {
+      workers.push_back(std::thread(buildInstances, std::cref(job), begin, std::min(n, begin + step)));
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+      workers[i].join();
+    }
+  }
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+  return n;
+}
+
+/* Core in GL 3.3, the 3.2 loader only has it through ARB_instanced_arrays */
+void vertexAttribDivisor(GLuint index, GLuint divisor) {
+  if(!GLAD_GL_ARB_instanced_arrays) {
+    stop("glVertexAttribDivisor needs ARB_instanced_arrays");
+  }
+  glVertexAttribDivisorARB(index, divisor);
+}
+
+//' Bind a buffer of instance matrices to four attribute slots
+//'
+//' A mat4 vertex attribute takes four consecutive locations, one vec4 column each.
+//' Sets them up for the layout written by instanceMatrices, advancing once per
+//' instance, on the currently bound vertex array.
+//' @param buffer GL buffer holding 16 floats per instance
+//' @param location attribute location of the mat4 (the first of its four slots)
+//' @param offset byte offset of the first matrix in the buffer
+//' @param divisor instances drawn per matrix
+//' @export
+// [[Rcpp::export]]
+void bindInstanceMatrixAttrib(unsigned int buffer, unsigned int location, double offset = 0, unsigned int divisor = 1) {
+  cachedBindBuffer(GL_ARRAY_BUFFER, buffer);
+  for (unsigned int i = 0; i < 4; i++) {
+    glEnableVertexAttribArray(location + i);
+    glVertexAttribPointer(location + i, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float),
+                          (void *) (size_t) (offset + i * 4 * sizeof(float)));
+    vertexAttribDivisor(location + i, divisor);
+  }
+}
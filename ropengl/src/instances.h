@@ -0,0 +1,9 @@
+#ifndef ROPENGL_INSTANCES_H
+#define ROPENGL_INSTANCES_H
+
+#include <glad/glad.h>
+
+/* glVertexAttribDivisor through whichever entry point the loader found */
+void vertexAttribDivisor(GLuint index, GLuint divisor);
+
+#endif
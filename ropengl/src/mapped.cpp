@@ -0,0 +1,79 @@
+#include "mapped.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Empty files cannot be mapped, they get a static zero length buffer instead */
+static const unsigned char empty[1] = { 0 };
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string & path) : bytes(NULL), length(0), file(INVALID_HANDLE_VALUE), mapping(NULL) {
+  file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER size;
+  if(!GetFileSizeEx(file, &size)) {
+    return;
+  }
+  length = (size_t) size.QuadPart;
+  if(length == 0) {
+    bytes = empty;
+    return;
+  }
+  mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if(mapping != NULL) {
+    bytes = (const unsigned char *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if(bytes != NULL && bytes != empty) {
+    UnmapViewOfFile(bytes);
+  }
+  if(mapping != NULL) {
+    CloseHandle(mapping);
+  }
+  if(file != INVALID_HANDLE_VALUE) {
+    CloseHandle(file);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string & path) : bytes(NULL), length(0), fd(-1) {
+  fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0) {
+    return;
+  }
+  struct stat st;
+  if(fstat(fd, &st) != 0) {
+    return;
+  }
+  length = (size_t) st.st_size;
+  if(length == 0) {
+    bytes = empty;
+    return;
+  }
+  void * p = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(p != MAP_FAILED) {
+    bytes = (const unsigned char *) p;
+  }
+}
+
+MappedFile::~MappedFile() {
+  if(bytes != NULL && bytes != empty) {
+    munmap((void *) bytes, length);
+  }
+  if(fd >= 0) {
+    close(fd);
+  }
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef ROPENGL_MAPPED_H
+#define ROPENGL_MAPPED_H
+
+#include <stddef.h>
+#include <string>
+
+/*
+ * Read-only memory mapping of a whole file, see mapped.cpp. data() is NULL when the
+ * file could not be opened or mapped; an empty file maps to size() 0.
+ */
+class MappedFile {
+public:
+  explicit MappedFile(const std::string & path);
+  ~MappedFile();
+  const unsigned char * data() const { return bytes; }
+  size_t size() const { return length; }
+  bool ok() const { return bytes != NULL; }
+
+private:
+  MappedFile(const MappedFile &);
+  MappedFile & operator=(const MappedFile &);
+  const unsigned char * bytes;
+  size_t length;
+#ifdef _WIN32
+  void * file;
+  void * mapping;
+#else
+  int fd;
+#endif
+};
+
+#endif
@@ -0,0 +1,248 @@
+#include "ropengl.h"
+#include <glm/ext.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "programs.h"
+using namespace Rcpp;
+
+/*
+ * mat4 / vec3 values that live on the C++ side. Every mat4* / vec3* operation works in
+ * place on its first argument and returns that same handle, so a transform chain
+ * allocates nothing in R; mat4ToMatrix / vec3ToVector convert only when asked.
+ * Operands that are vectors may be given as vec3 handles or plain numeric(3).
+ */
+static SEXP tagged(SEXP ptr, const char * cls) {
+  Rf_setAttrib(ptr, R_ClassSymbol, Rf_mkString(cls));
+  return ptr;
+}
+
+glm::mat4 * mat4Ptr(SEXP m) {
+  if(TYPEOF(m) != EXTPTRSXP || !Rf_inherits(m, "mat4")) {
+    stop("expected a mat4 handle");
+  }
+  glm::mat4 * p = XPtr<glm::mat4>(m).get();
+  if(p == NULL) {
+    stop("mat4 handle is no longer valid");
+  }
+  return p;
+}
+
+static glm::vec3 * vec3Ptr(SEXP v) {
+  if(TYPEOF(v) != EXTPTRSXP || !Rf_inherits(v, "vec3")) {
+    stop("expected a vec3 handle");
+  }
+  glm::vec3 * p = XPtr<glm::vec3>(v).get();
+  if(p == NULL) {
+    stop("vec3 handle is no longer valid");
+  }
+  return p;
+}
+
+glm::vec3 vec3Arg(SEXP v) {
+  if(TYPEOF(v) == EXTPTRSXP) {
+    return *vec3Ptr(v);
+  }
+  NumericVector vec(v);
+  if(vec.size() != 3) {
+    stop("expected a vec3 handle or a numeric vector of length 3");
+  }
+  return asVec3(vec);
+}
+
+//' Create a native 4x4 matrix
+//' @param mat optional R matrix to copy, identity when NULL
+//' @return mat4 handle
+//' @export
+// [[Rcpp::export]]
+SEXP mat4(SEXP mat = R_NilValue) {
+  glm::mat4 * m = new glm::mat4(1.0f);
+  if(!Rf_isNull(mat)) {
+    *m = asMat4(NumericMatrix(mat));
+  }
+  return tagged(XPtr<glm::mat4>(m, true), "mat4");
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Copy(SEXP m) {
+  return tagged(XPtr<glm::mat4>(new glm::mat4(*mat4Ptr(m)), true), "mat4");
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Set(SEXP m, SEXP other) {
+  *mat4Ptr(m) = *mat4Ptr(other);
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Identity(SEXP m) {
+  *mat4Ptr(m) = glm::mat4(1.0f);
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Ortho(SEXP m, float left, float right, float bottom, float top, float zNear, float zFar) {
+  *mat4Ptr(m) = glm::ortho(left, right, bottom, top, zNear, zFar);
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Perspective(SEXP m, float fov, float aspect, float zNear, float zFar) {
+  *mat4Ptr(m) = glm::perspective(fov, aspect, zNear, zFar);
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4LookAt(SEXP m, SEXP eye, SEXP center, SEXP up) {
+  *mat4Ptr(m) = glm::lookAt(vec3Arg(eye), vec3Arg(center), vec3Arg(up));
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Translate(SEXP m, SEXP vec) {
+  glm::mat4 * p = mat4Ptr(m);
+  *p = glm::translate(*p, vec3Arg(vec));
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Rotate(SEXP m, float angle, SEXP axis) {
+  glm::mat4 * p = mat4Ptr(m);
+  *p = glm::rotate(*p, angle, vec3Arg(axis));
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Scale(SEXP m, SEXP vec) {
+  glm::mat4 * p = mat4Ptr(m);
+  *p = glm::scale(*p, vec3Arg(vec));
+  return m;
+}
+
+//' Multiply a mat4 in place
+//' @param m mat4 handle receiving the product
+//' @param other mat4 handle
+//' @param pre compute other * m instead of m * other
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Multiply(SEXP m, SEXP other, bool pre = false) {
+  glm::mat4 * p = mat4Ptr(m);
+  *p = pre ? *mat4Ptr(other) * *p : *p * *mat4Ptr(other);
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Inverse(SEXP m) {
+  glm::mat4 * p = mat4Ptr(m);
+  *p = glm::inverse(*p);
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP mat4Transpose(SEXP m) {
+  glm::mat4 * p = mat4Ptr(m);
+  *p = glm::transpose(*p);
+  return m;
+}
+
+//' @export
+// [[Rcpp::export]]
+NumericMatrix mat4ToMatrix(SEXP m) {
+  return asNumericMatrix(*mat4Ptr(m), 4, 4);
+}
+
+//' Upload a mat4 handle to a uniform of the current program
+//' @param location uniform location
+//' @param m mat4 handle
+//' @export
+// [[Rcpp::export]]
+void uniformMat4(int location, SEXP m) {
+  uniformsTouched();
+  glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(*mat4Ptr(m)));
+}
+
+//' Create a native 3 component vector
+//' @param x x component, or a numeric vector of length 3
+//' @param y y component
+//' @param z z component
+//' @return vec3 handle
+//' @export
+// [[Rcpp::export]]
+SEXP vec3(SEXP x = R_NilValue, double y = 0, double z = 0) {
+  glm::vec3 * v = new glm::vec3(0.0f);
+  if(Rf_length(x) == 3) {
+    *v = vec3Arg(x);
+  }
+  else if(!Rf_isNull(x)) {
+    *v = glm::vec3(Rf_asReal(x), y, z);
+  }
+  return tagged(XPtr<glm::vec3>(v, true), "vec3");
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP vec3Set(SEXP v, SEXP other) {
+  *vec3Ptr(v) = vec3Arg(other);
+  return v;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP vec3Add(SEXP v, SEXP other) {
+  glm::vec3 * p = vec3Ptr(v);
+  *p = *p + vec3Arg(other);
+  return v;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP vec3Scale(SEXP v, double s) {
+  glm::vec3 * p = vec3Ptr(v);
+  *p = *p * (float) s;
+  return v;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP vec3Normalize(SEXP v) {
+  glm::vec3 * p = vec3Ptr(v);
+  *p = glm::normalize(*p);
+  return v;
+}
+
+//' @export
+// [[Rcpp::export]]
+SEXP vec3Cross(SEXP v, SEXP other) {
+  glm::vec3 * p = vec3Ptr(v);
+  *p = glm::cross(*p, vec3Arg(other));
+  return v;
+}
+
+//' Transform a vec3 in place by a mat4
+//' @param v vec3 handle
+//' @param m mat4 handle
+//' @param w homogeneous coordinate, 1 for points and 0 for directions
+//' @export
+// [[Rcpp::export]]
+SEXP vec3Transform(SEXP v, SEXP m, double w = 1) {
+  glm::vec3 * p = vec3Ptr(v);
+  glm::vec4 r = *mat4Ptr(m) * glm::vec4(p->x, p->y, p->z, (float) w);
+  *p = glm::vec3(r.x, r.y, r.z);
+  return v;
+}
+
+//' @export
+// [[Rcpp::export]]
+NumericVector vec3ToVector(SEXP v) {
+  glm::vec3 * p = vec3Ptr(v);
+  return NumericVector::create(p->x, p->y, p->z);
+}
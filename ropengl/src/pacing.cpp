@@ -0,0 +1,140 @@
+#include <Rcpp.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "pacing.h"
+using namespace Rcpp;
+
+/*
+ * Frame limiter and frame-time recorder. The limiter sleeps until shortly before the
+ * next frame is due and spins with yields for the rest, since sleeps overshoot by up
+ * to a scheduler tick (about 15ms on Windows by default). The spin margin follows the
+ * worst recent overshoot. Frames are due at a fixed cadence; one that is more than a
+ * whole period late restarts the cadence instead of rushing the following frames.
+ *
+ * The recorder keeps the last frameWindow flip-to-flip intervals in a ring.
+ */
+typedef std::chrono::steady_clock Clock;
+
+static const size_t frameWindow = 1024;
+static std::vector<double> frameTimes(frameWindow);
+static size_t frameCount = 0;
+static Clock::time_point lastFrame;
+static bool haveLastFrame = false;
+
+static double targetPeriod = 0;
+static Clock::time_point nextFrame;
+static double spinMargin = 0.002;
+
+static double since(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double>(to - from).count();
+}
+
+void waitForFrame() {
+  if(targetPeriod <= 0) {
+    return;
+  }
+  Clock::time_point now = Clock::now();
+  Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetPeriod));
+  if(since(nextFrame, now) > targetPeriod) {
+    nextFrame = now + period;
+    return;
+  }
+  double remaining = since(now, nextFrame);
+  if(remaining > spinMargin) {
+    Clock::time_point wake = nextFrame - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinMargin));
+    std::this_thread::sleep_until(wake);
+    double overshoot = since(wake, Clock::now());
+    spinMargin = std::min(0.02, std::max(0.0005, std::max(overshoot * 1.25, spinMargin * 0.99)));
+  }
+  while(Clock::now() < nextFrame) {
+    std::this_thread::yield();
+  }
+  nextFrame += period;
+}
+
+void recordFrame() {
+  Clock::time_point now = Clock::now();
+  if(haveLastFrame) {
+    frameTimes[frameCount % frameWindow] = since(lastFrame, now);
+    frameCount++;
+  }
+  lastFrame = now;
+  haveLastFrame = true;
+}
+
+//' Set the swap interval
+//' @param interval number of vertical blanks each flip waits for, 0 for no vsync
+//' @export
+// [[Rcpp::export]]
+void setSwapInterval(int interval) {
+  if(interval < 0) {
+    stop("interval must not be negative");
+  }
+  glfwSwapInterval(interval);
+}
+
+//' Limit the frame rate
+//'
+//' flip() waits until the next frame is due before swapping, sleeping for most of the
+//' wait and spinning for the last millisecond or two for accuracy. Mostly useful with
+//' setSwapInterval(0); with vsync on the swap itself already paces frames.
+//' @param fps target frames per second, 0 to turn the limiter off
+//' @export
+// [[Rcpp::export]]
+void setFrameRate(double fps = 0) {
+  if(fps < 0) {
+    stop("fps must not be negative");
+  }
+  targetPeriod = fps > 0 ? 1 / fps : 0;
+  nextFrame = Clock::now();
+}
+
+//' Frame time statistics
+//'
+//' Computed over the last 1024 flip-to-flip intervals.
+//' @param deadline frame time budget in seconds for counting missed frames; 0 uses the
+//' setFrameRate target, or 1/60 without one
+//' @param reset forget the recorded frames after reading them
+//' @return list with the number of frames in the window, the mean, median, 95th and
+//' 99th percentile and longest frame time in seconds, the deadline and the number of
+//' frames that took longer than it
+//' @export
+// [[Rcpp::export]]
+List frameTimeStats(double deadline = 0, bool reset = false) {
+  if(deadline <= 0) {
+    deadline = targetPeriod > 0 ? targetPeriod : 1.0 / 60;
+  }
+  std::vector<double> times(frameTimes.begin(), frameTimes.begin() + std::min(frameCount, frameWindow));
+  double mean = NA_REAL, p50 = NA_REAL, p95 = NA_REAL, p99 = NA_REAL, longest = NA_REAL;
+  int missed = 0;
+  if(!times.empty()) {
+    std::sort(times.begin(), times.end());
+    double sum = 0;
+    for (size_t i = 0; i < times.size(); i++) {
+      sum += times[i];
+      /* A little slack so frames paced exactly at the deadline do not count */
+      missed += times[i] > deadline * 1.05;
+    }
+    mean = sum / times.size();
+    p50 = times[(times.size() - 1) * 50 / 100];
+    p95 = times[(times.size() - 1) * 95 / 100];
+    p99 = times[(times.size() - 1) * 99 / 100];
+    longest = times.back();
+  }
+  List out = List::create(_["frames"] = (double) times.size(),
+                          _["mean"] = mean,
+                          _["p50"] = p50,
+                          _["p95"] = p95,
+                          _["p99"] = p99,
+                          _["max"] = longest,
+                          _["deadline"] = deadline,
+                          _["missed"] = missed);
+  if(reset) {
+    frameCount = 0;
+    haveLastFrame = false;
+  }
+  return out;
+}
@@ -0,0 +1,12 @@
+#ifndef ROPENGL_PACING_H
+#define ROPENGL_PACING_H
+
+/*
+ * Frame pacing, see pacing.cpp. flip() calls waitForFrame before swapping, which holds
+ * the frame back to the setFrameRate target, and recordFrame after it, which adds the
+ * time since the previous flip to the frame-time window.
+ */
+void waitForFrame();
+void recordFrame();
+
+#endif
@@ -0,0 +1,479 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "mapped.h"
+#include "programcache.h"
+#include "programs.h"
+#include "shaders.h"
+#include "state.h"
+using namespace Rcpp;
+
+/*
+ * Program binaries are stored as <cacheDir>/<key>.bin: a small header (magic, binary
+ * format, length, key) followed by the glGetProgramBinary blob. The key covers the
+ * GL vendor, renderer and version strings, so a driver update simply misses. A blob
+ * the driver refuses is treated as a miss and overwritten by the fresh link.
+ *
+ * buildPrograms does the same for a whole batch, issuing every compile and link before
+ * the first status query so drivers with background compiler threads can overlap them.
+ */
+struct BinaryHeader {
+  char magic[4];
+  GLuint format;
+  GLuint length;
+  GLuint reserved;
+  unsigned long long key;
+};
+
+static struct {
+  double hits;
+  double misses;
+  double rejected;
+  double stored;
+  double buildSeconds;
+  double loadSeconds;
+} cacheStats;
+
+static double seconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool binariesSupported() {
+  if(!GLAD_GL_ARB_get_program_binary) {
+    return false;
+  }
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+static std::string binaryPath(const std::string & cacheDir, unsigned long long key) {
+  char name[32];
+  snprintf(name, sizeof name, "%016llx.bin", key);
+  return cacheDir + "/" + name;
+}
+
+/* Insert #define lines after #version, then restore the original line numbering */
+std::string withDefines(const std::string & source, const std::vector<std::string> & defines) {
+  if(defines.empty()) {
+    return source;
+  }
+  std::string block;
+  for (size_t i = 0; i < defines.size(); i++) {
+    std::string define = defines[i];
+    size_t equals = define.find('=');
+    if(equals != std::string::npos) {
+      define[equals] = ' ';
+    }
+    block += "#define " + define + "\n";
+  }
+  size_t version = source.find("#version");
+  if(version == std::string::npos) {
+    return block + "#line 1 0\n" + source;
+  }
+  size_t eol = source.find('\n', version);
+  eol = eol == std::string::npos ? source.size() : eol + 1;
+  int line = 1 + std::count(source.begin(), source.begin() + eol, '\n');
+  char directive[32];
+  snprintf(directive, sizeof directive, "#line %d 0\n", line);
+  std::string head = source.substr(0, eol);
+  if(eol == source.size() && (head.empty() || head[head.size() - 1] != '\n')) {
+    head += "\n";
+  }
+  return head + block + directive + source.substr(eol);
+}
+
+unsigned long long programKey(const std::vector<ProgramStage> & stages, const std::vector<std::string> & defines) {
+  unsigned long long key = hashBytes("ropengl program binary 1", 24);
+  const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+  for (int i = 0; i < 4; i++) {
+    const char * value = (const char *) glGetString(names[i]);
+    if(value != NULL) {
+      key = hashBytes(value, strlen(value) + 1, key);
+    }
+  }
+  for (size_t i = 0; i < stages.size(); i++) {
+    key = hashBytes(&stages[i].type, sizeof stages[i].type, key);
+    key = hashBytes(stages[i].source.c_str(), stages[i].source.size() + 1, key);
+  }
+  for (size_t i = 0; i < defines.size(); i++) {
+    key = hashBytes(defines[i].c_str(), defines[i].size() + 1, key);
+  }
+  return key;
+}
+
+GLuint loadProgramBinary(unsigned long long key, const std::string & cacheDir) {
+  if(cacheDir.empty() || !binariesSupported()) {
+    return 0;
+  }
+  MappedFile file(binaryPath(cacheDir, key));
+  BinaryHeader header;
+  if(!file.ok() || file.size() < sizeof header) {
+    return 0;
+  }
+  memcpy(&header, file.data(), sizeof header);
+  if(memcmp(header.magic, "RGLB", 4) != 0 || header.key != key || sizeof header + header.length > file.size()) {
+    cacheStats.rejected++;
+    return 0;
+  }
+  GLuint program = glCreateProgram();
+  glProgramBinary(program, header.format, file.data() + sizeof header, header.length);
+  GLint status = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if(status != GL_TRUE) {
+    glDeleteProgram(program);
+    cacheStats.rejected++;
+    return 0;
+  }
+  return program;
+}
+
+void storeProgramBinary(GLuint program, unsigned long long key, const std::string & cacheDir) {
+  if(cacheDir.empty() || !binariesSupported()) {
+    return;
+  }
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if(length <= 0) {
+    return;
+  }
+  std::vector<unsigned char> blob(length);
+  BinaryHeader header;
+  memcpy(header.magic, "RGLB", 4);
+  header.reserved = 0;
+  header.key = key;
+  glGetProgramBinary(program, length, &length, &header.format, &blob[0]);
+  header.length = length;
+  std::string path = binaryPath(cacheDir, key);
+  std::string temporary = path + ".tmp";
+  FILE * out = fopen(temporary.c_str(), "wb");
+  if(out == NULL) {
+    return;
+  }
+  bool written = fwrite(&header, sizeof header, 1, out) == 1 && fwrite(&blob[0], 1, length, out) == (size_t) length;
+  written = fclose(out) == 0 && written;
+  remove(path.c_str());
+  if(!written || rename(temporary.c_str(), path.c_str()) != 0) {
+    remove(temporary.c_str());
+    return;
+  }
+  cacheStats.stored++;
+}
+
+static const char * stageName(GLenum type) {
+  switch(type) {
+  case GL_VERTEX_SHADER:
+    return "vertex shader";
+  case GL_GEOMETRY_SHADER:
+    return "geometry shader";
+  case GL_FRAGMENT_SHADER:
+    return "fragment shader";
+  }
+  return "shader";
+}
+
+/* The stage name and mapped compile log of a shader that failed, empty otherwise */
+static std::string compileError(GLuint shader, GLenum type) {
+  GLint status = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if(status == GL_TRUE) {
+    return "";
+  }
+  GLint length = 0;
+  glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+  std::vector<char> log(length + 1, 0);
+  glGetShaderInfoLog(shader, length + 1, NULL, &log[0]);
+  return std::string(stageName(type)) + ": " + mapShaderLog(shader, &log[0]);
+}
+
+static GLuint submitShaderStage(const ProgramStage & stage) {
+  GLuint shader = glCreateShader(stage.type);
+  const char * text = stage.source.c_str();
+  glShaderSource(shader, 1, &text, NULL);
+  noteShaderSource(shader, stage.source);
+  glCompileShader(shader);
+  return shader;
+}
+
+GLuint compileShaderStage(const ProgramStage & stage) {
+  GLuint shader = submitShaderStage(stage);
+  std::string message = compileError(shader, stage.type);
+  if(!message.empty()) {
+    forgetShaderSource(shader);
+    glDeleteShader(shader);
+    stop(message);
+  }
+  return shader;
+}
+
+std::string linkError(GLuint program) {
+  GLint status = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if(status == GL_TRUE) {
+    return "";
+  }
+  GLint length = 0;
+  glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+  std::vector<char> log(length + 1, 0);
+  glGetProgramInfoLog(program, length + 1, NULL, &log[0]);
+  return std::string("link failed: ") + &log[0];
+}
+
+static std::vector<ProgramStage> programStages(const std::string & vertex, const std::string & fragment, const std::string & geometry, const std::vector<std::string> & defines) {
+  std::vector<ProgramStage> stages;
+  ProgramStage stage;
+  stage.type = GL_VERTEX_SHADER;
+  stage.source = withDefines(vertex, defines);
+  stages.push_back(stage);
+  if(!geometry.empty()) {
+    stage.type = GL_GEOMETRY_SHADER;
+    stage.source = withDefines(geometry, defines);
+    stages.push_back(stage);
+  }
+  stage.type = GL_FRAGMENT_SHADER;
+  stage.source = withDefines(fragment, defines);
+  stages.push_back(stage);
+  return stages;
+}
+
+//' Build a program, reusing a cached program binary when possible
+//'
+//' The stages are compiled and linked as usual the first time; with a cacheDir the
+//' linked binary is stored there and later builds of the same sources, defines and
+//' driver load it with glProgramBinary instead. A binary the driver rejects falls back
+//' to compiling. The program is reflected like one linked with glLinkProgram.
+//' @param vertex vertex shader source
+//' @param fragment fragment shader source
+//' @param geometry optional geometry shader source
+//' @param defines "NAME" or "NAME=VALUE" strings defined after the #version line
+//' @param cacheDir directory for program binaries, no caching when empty
+//' @return GL program name
+//' @export
+// [[Rcpp::export]]
+unsigned int buildProgram(std::string vertex, std::string fragment, std::string geometry = "", CharacterVector defines = CharacterVector::create(), std::string cacheDir = "") {
+  double start = seconds();
+  std::vector<std::string> defineLines = as<std::vector<std::string> >(defines);
+  std::vector<ProgramStage> stages = programStages(vertex, fragment, geometry, defineLines);
+  unsigned long long key = programKey(stages, defineLines);
+  GLuint program = loadProgramBinary(key, cacheDir);
+  if(program != 0) {
+    reflectProgram(program);
+    cacheStats.hits++;
+    cacheStats.loadSeconds += seconds() - start;
+    return program;
+  }
+  std::vector<GLuint> shaders;
+  try {
+    for (size_t i = 0; i < stages.size(); i++) {
+      shaders.push_back(compileShaderStage(stages[i]));
+    }
+  }
+  catch(...) {
+    for (size_t i = 0; i < shaders.size(); i++) {
+      forgetShaderSource(shaders[i]);
+      glDeleteShader(shaders[i]);
+    }
+    throw;
+  }
+  program = glCreateProgram();
+  if(!cacheDir.empty() && GLAD_GL_ARB_get_program_binary) {
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+  for (size_t i = 0; i < shaders.size(); i++) {
+    glAttachShader(program, shaders[i]);
+  }
+  glLinkProgram(program);
+  for (size_t i = 0; i < shaders.size(); i++) {
+    glDetachShader(program, shaders[i]);
+    forgetShaderSource(shaders[i]);
+    glDeleteShader(shaders[i]);
+  }
+  std::string error = linkError(program);
+  if(!error.empty()) {
+    glDeleteProgram(program);
+    stop(error);
+  }
+  reflectProgram(program);
+  storeProgramBinary(program, key, cacheDir);
+  cacheStats.misses++;
+  cacheStats.buildSeconds += seconds() - start;
+  return program;
+}
+
+struct PendingProgram {
+  unsigned long long key;
+  std::vector<ProgramStage> stages;
+  std::vector<GLuint> shaders;
+  GLuint program;
+  bool cached;
+  bool complete;
+  std::string log;
+};
+
+/* Let the driver compile on as many threads as it likes; false without the extension */
+static bool parallelCompile() {
+  if(GLAD_GL_KHR_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    return true;
+  }
+  if(GLAD_GL_ARB_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    return true;
+  }
+  return false;
+}
+
+static std::string element(CharacterVector x, R_xlen_t i) {
+  return x.size() == 0 ? "" : as<std::string>(x[i % x.size()]);
+}
+
+//' Build many programs at once
+//'
+//' Every compile and link is issued before any status is queried, so the driver can
+//' work on them in parallel; with KHR_parallel_shader_compile (or the ARB version) it
+//' is allowed all the compiler threads it wants and completion is polled without
+//' blocking. Cached binaries are used as in buildProgram. A program that fails does not
+//' stop the batch: its row has program 0 and the compile or link log.
+//' @param vertex vertex shader sources
+//' @param fragment fragment shader sources
+//' @param geometry geometry shader sources, "" or none for programs without one
+//' @param defines a character vector of "NAME" or "NAME=VALUE" strings for every
+//' program, or a list with one such vector per program
+//' @param cacheDir directory for program binaries, no caching when empty
+//' @return data.frame with the GL program name, whether it came from the binary cache,
+//' and the info log, one row per program; shorter arguments are recycled
+//' @export
+// [[Rcpp::export]]
+DataFrame buildPrograms(CharacterVector vertex, CharacterVector fragment, CharacterVector geometry = CharacterVector::create(), SEXP defines = R_NilValue, std::string cacheDir = "") {
+  double start = seconds();
+  R_xlen_t n = std::max(vertex.size(), fragment.size());
+  if(vertex.size() == 0 || fragment.size() == 0) {
+    n = 0;
+  }
+  bool perProgram = TYPEOF(defines) == VECSXP;
+  if(!Rf_isNull(defines) && !perProgram && TYPEOF(defines) != STRSXP) {
+    stop("defines must be a character vector or a list of them");
+  }
+  if(perProgram && Rf_length(defines) == 0 && n > 0) {
+    stop("defines must not be an empty list");
+  }
+  std::vector<PendingProgram> pending(n);
+  for (R_xlen_t i = 0; i < n; i++) {
+    std::vector<std::string> defineLines;
+    if(perProgram) {
+      defineLines = as<std::vector<std::string> >(VECTOR_ELT(defines, i % Rf_length(defines)));
+    }
+    else if(!Rf_isNull(defines)) {
+      defineLines = as<std::vector<std::string> >(defines);
+    }
+    PendingProgram & p = pending[i];
+    p.stages = programStages(element(vertex, i), element(fragment, i), element(geometry, i), defineLines);
+    p.key = programKey(p.stages, defineLines);
+    p.program = loadProgramBinary(p.key, cacheDir);
+    p.cached = p.complete = p.program != 0;
+    if(p.cached) {
+      reflectProgram(p.program);
+      cacheStats.hits++;
+    }
+  }
+  double loaded = seconds();
+  cacheStats.loadSeconds += loaded - start;
+  bool parallel = parallelCompile();
+  for (size_t i = 0; i < pending.size(); i++) {
+    for (size_t s = 0; !pending[i].cached && s < pending[i].stages.size(); s++) {
+      pending[i].shaders.push_back(submitShaderStage(pending[i].stages[s]));
+    }
+  }
+  for (size_t i = 0; i < pending.size(); i++) {
+    PendingProgram & p = pending[i];
+    if(p.cached) {
+      continue;
+    }
+    p.program = glCreateProgram();
+    if(!cacheDir.empty() && GLAD_GL_ARB_get_program_binary) {
+      glProgramParameteri(p.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    for (size_t s = 0; s < p.shaders.size(); s++) {
+      glAttachShader(p.program, p.shaders[s]);
+    }
+    glLinkProgram(p.program);
+  }
+  /* Without the extension the first status query below simply waits for its link */
+  for (bool waiting = parallel; waiting; ) {
+    waiting = false;
+    for (size_t i = 0; i < pending.size(); i++) {
+      if(!pending[i].complete) {
+        GLint status = GL_FALSE;
+        glGetProgramiv(pending[i].program, GL_COMPLETION_STATUS_KHR, &status);
+        pending[i].complete = status == GL_TRUE;
+        waiting = waiting || !pending[i].complete;
+      }
+    }
+    if(waiting) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  NumericVector programs(n);
+  LogicalVector cached(n);
+  CharacterVector logs(n);
+  for (size_t i = 0; i < pending.size(); i++) {
+    PendingProgram & p = pending[i];
+    if(!p.cached) {
+      p.log = linkError(p.program);
+      if(!p.log.empty()) {
+        /* A stage that did not compile explains the failed link better */
+        std::string compileLog;
+        for (size_t s = 0; s < p.shaders.size(); s++) {
+          std::string error = compileError(p.shaders[s], p.stages[s].type);
+          compileLog += compileLog.empty() || error.empty() ? error : "\n" + error;
+        }
+        if(!compileLog.empty()) {
+          p.log = compileLog;
+        }
+      }
+      for (size_t s = 0; s < p.shaders.size(); s++) {
+        glDetachShader(p.program, p.shaders[s]);
+        forgetShaderSource(p.shaders[s]);
+        glDeleteShader(p.shaders[s]);
+      }
+      if(p.log.empty()) {
+        reflectProgram(p.program);
+        storeProgramBinary(p.program, p.key, cacheDir);
+      }
+      else {
+        glDeleteProgram(p.program);
+        p.program = 0;
+      }
+      cacheStats.misses++;
+    }
+    programs[i] = p.program;
+    cached[i] = p.cached;
+    logs[i] = p.log;
+  }
+  cacheStats.buildSeconds += seconds() - loaded;
+  return DataFrame::create(_["program"] = programs, _["cached"] = cached, _["log"] = logs,
+                           _["stringsAsFactors"] = false);
+}
+
+//' Program binary cache statistics
+//' @param reset zero the counters after reading them
+//' @return list with cache hits, misses, binaries rejected by the driver or unreadable,
+//' binaries stored, and the seconds spent building on misses and loading on hits
+//' @export
+// [[Rcpp::export]]
+List programCacheStats(bool reset = false) {
+  List out = List::create(_["hits"] = cacheStats.hits,
+                          _["misses"] = cacheStats.misses,
+                          _["rejected"] = cacheStats.rejected,
+                          _["stored"] = cacheStats.stored,
+                          _["buildSeconds"] = cacheStats.buildSeconds,
+                          _["loadSeconds"] = cacheStats.loadSeconds);
+  if(reset) {
+    memset(&cacheStats, 0, sizeof cacheStats);
+  }
+  return out;
+}
@@ -0,0 +1,25 @@
+#ifndef ROPENGL_PROGRAMCACHE_H
+#define ROPENGL_PROGRAMCACHE_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+/*
+ * Program building with an on-disk binary cache, see programcache.cpp. programKey
+ * hashes the stage sources, the defines and the driver identity; loadProgramBinary
+ * returns a linked program for a key or 0 when there is no usable binary.
+ */
+struct ProgramStage {
+  GLenum type;
+  std::string source;
+};
+
+std::string withDefines(const std::string & source, const std::vector<std::string> & defines);
+unsigned long long programKey(const std::vector<ProgramStage> & stages, const std::vector<std::string> & defines);
+GLuint loadProgramBinary(unsigned long long key, const std::string & cacheDir);
+void storeProgramBinary(GLuint program, unsigned long long key, const std::string & cacheDir);
+GLuint compileShaderStage(const ProgramStage & stage);
+std::string linkError(GLuint program);
+
+#endif
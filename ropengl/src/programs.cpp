@@ -0,0 +1,319 @@
+#include "ropengl.h"
+#include <map>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include "programs.h"
+#include "state.h"
+using namespace Rcpp;
+
+/*
+ * Name -> location/type/size tables built from glGetActiveUniform / glGetActiveAttrib
+ * right after a successful link. Every uniform also keeps the words it was last set to
+ * through setUniform, stamped with uniformGeneration, so an unchanged value is not
+ * uploaded again unless a plain glUniform* call happened in between.
+ */
+enum UniformKind {
+  UNIFORM_FLOAT,
+  UNIFORM_INT,
+  UNIFORM_UINT,
+  UNIFORM_MATRIX
+};
+
+struct UniformInfo {
+  GLint location;
+  GLenum type;
+  GLint size;
+  bool array;
+  std::vector<GLuint> value;
+  unsigned int generation;
+};
+
+struct AttribInfo {
+  GLint location;
+  GLenum type;
+  GLint size;
+};
+
+struct ProgramInfo {
+  std::map<std::string, UniformInfo> uniforms;
+  std::map<std::string, AttribInfo> attribs;
+};
+
+unsigned int uniformGeneration = 0;
+static std::map<GLuint, ProgramInfo> programs;
+
+/* Uniform arrays are reported as "name[0]", make them reachable as "name" too */
+static std::string baseName(const char * name) {
+  std::string out(name);
+  size_t n = out.size();
+  if(n > 3 && out.compare(n - 3, 3, "[0]") == 0) {
+    out.erase(n - 3);
+  }
+  return out;
+}
+
+void reflectProgram(GLuint program) {
+  ProgramInfo & info = programs[program];
+  info.uniforms.clear();
+  info.attribs.clear();
+  GLint count = 0, length = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length);
+  std::vector<char> name(length + 1);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  for (GLint i = 0; i < count; i++) {
+    UniformInfo u;
+    glGetActiveUniform(program, i, name.size(), NULL, &u.size, &u.type, &name[0]);
+    u.location = glGetUniformLocation(program, &name[0]);
+    u.array = u.size > 1;
+    u.generation = 0;
+    info.uniforms[baseName(&name[0])] = u;
+    info.uniforms[&name[0]] = u;
+  }
+  glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length);
+  name.resize(length + 1);
+  glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+  for (GLint i = 0; i < count; i++) {
+    AttribInfo a;
+    glGetActiveAttrib(program, i, name.size(), NULL, &a.size, &a.type, &name[0]);
+    a.location = glGetAttribLocation(program, &name[0]);
+    info.attribs[&name[0]] = a;
+  }
+}
+
+void forgetProgram(GLuint program) {
+  programs.erase(program);
+}
+
+static UniformInfo * findUniform(GLuint program, const std::string & name) {
+  std::map<GLuint, ProgramInfo>::iterator p = programs.find(program);
+  if(p == programs.end()) {
+    return NULL;
+  }
+  std::map<std::string, UniformInfo> & uniforms = p->second.uniforms;
+  std::map<std::string, UniformInfo>::iterator it = uniforms.find(name);
+  if(it != uniforms.end()) {
+    return &it->second;
+  }
+  /* an element inside an array, e.g. "lights[3]": resolve once and remember it */
+  size_t open = name.rfind('[');
+  if(open == std::string::npos || name[name.size() - 1] != ']') {
+    return NULL;
+  }
+  it = uniforms.find(name.substr(0, open));
+  if(it == uniforms.end()) {
+    return NULL;
+  }
+  int index = atoi(name.c_str() + open + 1);
+  if(index < 0 || index >= it->second.size) {
+    return NULL;
+  }
+  UniformInfo u = it->second;
+  u.location = glGetUniformLocation(program, name.c_str());
+  u.size -= index;
+  u.value.clear();
+  return &(uniforms[name] = u);
+}
+
+GLint cachedUniformLocation(GLuint program, const std::string & name) {
+  if(programs.count(program) == 0) {
+    return glGetUniformLocation(program, name.c_str());
+  }
+  UniformInfo * u = findUniform(program, name);
+  return u == NULL ? -1 : u->location;
+}
+
+GLint cachedAttribLocation(GLuint program, const std::string & name) {
+  std::map<GLuint, ProgramInfo>::iterator p = programs.find(program);
+  if(p == programs.end()) {
+    return glGetAttribLocation(program, name.c_str());
+  }
+  std::map<std::string, AttribInfo>::iterator it = p->second.attribs.find(name);
+  return it == p->second.attribs.end() ? -1 : it->second.location;
+}
+
+/* How values of a GLSL type are uploaded: kind and words per element */
+static UniformKind uniformKind(GLenum type, int * components) {
+  switch(type) {
+  case GL_FLOAT: *components = 1; return UNIFORM_FLOAT;
+  case GL_FLOAT_VEC2: *components = 2; return UNIFORM_FLOAT;
+  case GL_FLOAT_VEC3: *components = 3; return UNIFORM_FLOAT;
+  case GL_FLOAT_VEC4: *components = 4; return UNIFORM_FLOAT;
+  case GL_INT_VEC2: case GL_BOOL_VEC2: *components = 2; return UNIFORM_INT;
+  case GL_INT_VEC3: case GL_BOOL_VEC3: *components = 3; return UNIFORM_INT;
+  case GL_INT_VEC4: case GL_BOOL_VEC4: *components = 4; return UNIFORM_INT;
+  case GL_UNSIGNED_INT: *components = 1; return UNIFORM_UINT;
+  case GL_UNSIGNED_INT_VEC2: *components = 2; return UNIFORM_UINT;
+  case GL_UNSIGNED_INT_VEC3: *components = 3; return UNIFORM_UINT;
+  case GL_UNSIGNED_INT_VEC4: *components = 4; return UNIFORM_UINT;
+  case GL_FLOAT_MAT2: *components = 4; return UNIFORM_MATRIX;
+  case GL_FLOAT_MAT3: *components = 9; return UNIFORM_MATRIX;
+  case GL_FLOAT_MAT4: *components = 16; return UNIFORM_MATRIX;
+  case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2: *components = 6; return UNIFORM_MATRIX;
+  case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2: *components = 8; return UNIFORM_MATRIX;
+  case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3: *components = 12; return UNIFORM_MATRIX;
+  }
+  /* int, bool and every sampler type */
+  *components = 1;
+  return UNIFORM_INT;
+}
+
+static void uploadUniform(const UniformInfo & u, GLsizei count, const GLuint * words) {
+  const GLfloat * f = (const GLfloat *) words;
+  const GLint * i = (const GLint *) words;
+  /* R matrices here are indexed [column, row] (see asMat4), hence the transpose */
+  switch(u.type) {
+  case GL_FLOAT: glUniform1fv(u.location, count, f); break;
+  case GL_FLOAT_VEC2: glUniform2fv(u.location, count, f); break;
+  case GL_FLOAT_VEC3: glUniform3fv(u.location, count, f); break;
+  case GL_FLOAT_VEC4: glUniform4fv(u.location, count, f); break;
+  case GL_INT_VEC2: case GL_BOOL_VEC2: glUniform2iv(u.location, count, i); break;
+  case GL_INT_VEC3: case GL_BOOL_VEC3: glUniform3iv(u.location, count, i); break;
+  case GL_INT_VEC4: case GL_BOOL_VEC4: glUniform4iv(u.location, count, i); break;
+  case GL_UNSIGNED_INT: glUniform1uiv(u.location, count, words); break;
+  case GL_UNSIGNED_INT_VEC2: glUniform2uiv(u.location, count, words); break;
+  case GL_UNSIGNED_INT_VEC3: glUniform3uiv(u.location, count, words); break;
+  case GL_UNSIGNED_INT_VEC4: glUniform4uiv(u.location, count, words); break;
+  case GL_FLOAT_MAT2: glUniformMatrix2fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT3: glUniformMatrix3fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT4: glUniformMatrix4fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT2x3: glUniformMatrix2x3fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT3x2: glUniformMatrix3x2fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT2x4: glUniformMatrix2x4fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT4x2: glUniformMatrix4x2fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT3x4: glUniformMatrix3x4fv(u.location, count, GL_TRUE, f); break;
+  case GL_FLOAT_MAT4x3: glUniformMatrix4x3fv(u.location, count, GL_TRUE, f); break;
+  default: glUniform1iv(u.location, count, i); break;
+  }
+}
+
+/* Convert an R value to the words glUniform* takes; mat4 handles are laid out like an R matrix */
+static std::vector<GLuint> uniformWords(SEXP value, UniformKind kind) {
+  if(TYPEOF(value) == EXTPTRSXP) {
+    glm::mat4 * m = mat4Ptr(value);
+    std::vector<GLuint> words(16);
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) {
+        memcpy(&words[i + 4 * j], &(*m)[i][j], sizeof(GLfloat));
+      }
+    }
+    return words;
+  }
+  R_xlen_t n = XLENGTH(value);
+  std::vector<GLuint> words(n);
+  for (R_xlen_t i = 0; i < n; i++) {
+    double x;
+    switch(TYPEOF(value)) {
+    case REALSXP:
+      x = REAL(value)[i];
+      break;
+    case INTSXP:
+    case LGLSXP:
+      x = INTEGER(value)[i];
+      break;
+    default:
+      stop("uniform values must be numeric, integer or logical vectors or a mat4 handle");
+    }
+    if(kind == UNIFORM_FLOAT || kind == UNIFORM_MATRIX) {
+      GLfloat f = (GLfloat) x;
+      memcpy(&words[i], &f, sizeof f);
+    }
+    else if(kind == UNIFORM_UINT) {
+      words[i] = (GLuint) x;
+    }
+    else {
+      words[i] = (GLuint) (GLint) x;
+    }
+  }
+  return words;
+}
+
+//' Set a uniform by name
+//'
+//' Uses the reflection done by glLinkProgram, so the type decides how the value is
+//' uploaded, and skips the upload when the uniform already holds the same value.
+//' Makes the program current.
+//' @param program linked program
+//' @param name uniform name as written in the shader, array elements as "name[i]"
+//' @param value numeric, integer or logical vector (or matrix) holding one or more elements, or a mat4 handle
+//' @return TRUE if the value was uploaded, FALSE if it was unchanged
+//' @export
+// [[Rcpp::export]]
+bool setUniform(unsigned int program, std::string name, SEXP value) {
+  if(programs.count(program) == 0) {
+    stop("program has not been linked through glLinkProgram");
+  }
+  UniformInfo * u = findUniform(program, name);
+  if(u == NULL) {
+    stop("no active uniform named " + name);
+  }
+  int components;
+  UniformKind kind = uniformKind(u->type, &components);
+  std::vector<GLuint> words = uniformWords(value, kind);
+  R_xlen_t n = words.size();
+  if(n == 0 || n % components != 0 || n / components > u->size) {
+    stop("uniform " + name + " takes a multiple of " + std::to_string(components) + " values, up to its array size");
+  }
+  if(u->generation == uniformGeneration && u->value == words) {
+    return false;
+  }
+  cachedUseProgram(program);
+  uploadUniform(*u, n / components, &words[0]);
+  if(u->array) {
+    /* "name", "name[0]" and "name[i]" entries alias each other's locations */
+    GLint end = u->location + n / components;
+    std::map<std::string, UniformInfo> & uniforms = programs[program].uniforms;
+    for (std::map<std::string, UniformInfo>::iterator it = uniforms.begin(); it != uniforms.end(); ++it) {
+      if(it->second.array && it->second.location < end && u->location < it->second.location + it->second.size) {
+        it->second.value.clear();
+      }
+    }
+  }
+  u->value.swap(words);
+  u->generation = uniformGeneration;
+  return true;
+}
+
+//' Active uniforms of a linked program
+//' @param program linked program
+//' @return data.frame with name, location, GL type enum and array size
+//' @export
+// [[Rcpp::export]]
+DataFrame programUniforms(unsigned int program) {
+  std::vector<std::string> names;
+  std::vector<int> locations, types, sizes;
+  std::map<GLuint, ProgramInfo>::iterator p = programs.find(program);
+  if(p != programs.end()) {
+    std::map<std::string, UniformInfo> & uniforms = p->second.uniforms;
+    for (std::map<std::string, UniformInfo>::iterator it = uniforms.begin(); it != uniforms.end(); ++it) {
+      names.push_back(it->first);
+      locations.push_back(it->second.location);
+      types.push_back(it->second.type);
+      sizes.push_back(it->second.size);
+    }
+  }
+  return DataFrame::create(_["name"] = names, _["location"] = locations, _["type"] = types,
+                           _["size"] = sizes, _["stringsAsFactors"] = false);
+}
+
+//' Active attributes of a linked program
+//' @param program linked program
+//' @return data.frame with name, location, GL type enum and array size
+//' @export
+// [[Rcpp::export]]
+DataFrame programAttributes(unsigned int program) {
+  std::vector<std::string> names;
+  std::vector<int> locations, types, sizes;
+  std::map<GLuint, ProgramInfo>::iterator p = programs.find(program);
+  if(p != programs.end()) {
+    std::map<std::string, AttribInfo> & attribs = p->second.attribs;
+    for (std::map<std::string, AttribInfo>::iterator it = attribs.begin(); it != attribs.end(); ++it) {
+      names.push_back(it->first);
+      locations.push_back(it->second.location);
+      types.push_back(it->second.type);
+      sizes.push_back(it->second.size);
+    }
+  }
+  return DataFrame::create(_["name"] = names, _["location"] = locations, _["type"] = types,
+                           _["size"] = sizes, _["stringsAsFactors"] = false);
+}
@@ -0,0 +1,23 @@
+#ifndef ROPENGL_PROGRAMS_H
+#define ROPENGL_PROGRAMS_H
+
+#include <glad/glad.h>
+#include <string>
+
+/*
+ * Program reflection, see programs.cpp. Linking through glLinkProgram records every
+ * active uniform and attribute so location lookups never reach the driver.
+ */
+void reflectProgram(GLuint program);
+void forgetProgram(GLuint program);
+GLint cachedUniformLocation(GLuint program, const std::string & name);
+GLint cachedAttribLocation(GLuint program, const std::string & name);
+
+/* Bumped by every plain glUniform* call, which setUniform's value shadow cannot see */
+extern unsigned int uniformGeneration;
+
+inline void uniformsTouched() {
+  uniformGeneration++;
+}
+
+#endif
@@ -0,0 +1,492 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <map>
+#include <string.h>
+#include <vector>
+#include "headless.h"
+#include "readback.h"
+#include "simd.h"
+#include "state.h"
+using namespace Rcpp;
+
+/*
+ * Asynchronous readback. Each read goes into the next free buffer of a small ring of
+ * pixel pack buffers with a fence behind it, so glReadPixels returns at once and the
+ * copy overlaps the following frames. Collecting a ticket waits on its fence only if
+ * the GPU has not got there yet, maps the buffer and copies it into the R vector.
+ *
+ * When every buffer is still waiting to be collected, the oldest one is copied out to
+ * host memory to make room; its ticket stays valid but that read was synchronous.
+ *
+ * readNativeRaster reads straight into the integer matrix R graphics use for images.
+ * Its RGBA bytes are GL's RGBA bytes on little-endian machines, so the read lands in
+ * place and only the rows need flipping, with opaque reads setting alpha in that pass.
+ */
+struct ReadbackSlot {
+  GLuint buffer;
+  GLsizeiptr capacity;
+  GLsync sync;
+  unsigned long long ticket;
+  int width;
+  int height;
+  GLenum format;
+  GLenum type;
+  size_t bytes;
+};
+
+struct SpilledReadback {
+  int width;
+  int height;
+  GLenum format;
+  GLenum type;
+  std::vector<unsigned char> pixels;
+};
+
+static std::vector<ReadbackSlot> slots(3);
+static std::map<unsigned long long, SpilledReadback> spilled;
+static unsigned long long nextTicket = 1;
+static ReadbackSlot * mapped = NULL;
+
+static struct {
+  double issued;
+  double collected;
+  double stalls;
+  double spills;
+} readStats;
+
+static int formatComponents(GLenum format) {
+  switch(format) {
+  case GL_RED:
+  case GL_GREEN:
+  case GL_BLUE:
+  case GL_RED_INTEGER:
+  case GL_GREEN_INTEGER:
+  case GL_BLUE_INTEGER:
+  case GL_DEPTH_COMPONENT:
+  case GL_STENCIL_INDEX:
+    return 1;
+  case GL_RG:
+  case GL_RG_INTEGER:
+  case GL_DEPTH_STENCIL:
+    return 2;
+  case GL_RGB:
+  case GL_BGR:
+  case GL_RGB_INTEGER:
+  case GL_BGR_INTEGER:
+    return 3;
+  case GL_RGBA:
+  case GL_BGRA:
+  case GL_RGBA_INTEGER:
+  case GL_BGRA_INTEGER:
+    return 4;
+  }
+  stop("unsupported pixel format " + std::to_string(format));
+  return 0;
+}
+
+/* Bytes per value, and whether one value holds the whole pixel */
+static int typeBytes(GLenum type, bool * packed) {
+  *packed = false;
+  switch(type) {
+  case GL_UNSIGNED_BYTE:
+  case GL_BYTE:
+    return 1;
+  case GL_UNSIGNED_SHORT:
+  case GL_SHORT:
+  case GL_HALF_FLOAT:
+    return 2;
+  case GL_UNSIGNED_INT:
+  case GL_INT:
+  case GL_FLOAT:
+    return 4;
+  case GL_UNSIGNED_SHORT_5_6_5:
+  case GL_UNSIGNED_SHORT_4_4_4_4:
+  case GL_UNSIGNED_SHORT_5_5_5_1:
+    *packed = true;
+    return 2;
+  case GL_UNSIGNED_INT_8_8_8_8:
+  case GL_UNSIGNED_INT_8_8_8_8_REV:
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_10F_11F_11F_REV:
+  case GL_UNSIGNED_INT_5_9_9_9_REV:
+  case GL_UNSIGNED_INT_24_8:
+    *packed = true;
+    return 4;
+  }
+  stop("unsupported pixel type " + std::to_string(type));
+  return 0;
+}
+
+size_t pixelBytes(GLenum format, GLenum type) {
+  bool packed;
+  int bytes = typeBytes(type, &packed);
+  return packed ? bytes : bytes * formatComponents(format);
+}
+
+template<typename T>
+static void copyToInteger(const void * pixels, int * dst, size_t n) {
+  const T * src = (const T *) pixels;
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+SEXP pixelVector(const void * pixels, int width, int height, GLenum format, GLenum type) {
+  bool packed;
+  int bytes = typeBytes(type, &packed);
+  int values = packed ? 1 : formatComponents(format);
+  size_t n = (size_t) width * height * values;
+  SEXP out;
+  switch(type) {
+  case GL_UNSIGNED_BYTE:
+    out = PROTECT(Rf_allocVector(RAWSXP, n));
+    memcpy(RAW(out), pixels, n);
+    break;
+  case GL_FLOAT:
+    out = PROTECT(Rf_allocVector(REALSXP, n));
+    widenFloat((const float *) pixels, REAL(out), n);
+    break;
+  case GL_BYTE:
+    out = PROTECT(Rf_allocVector(INTSXP, n));
+    copyToInteger<signed char>(pixels, INTEGER(out), n);
+    break;
+  case GL_SHORT:
+    out = PROTECT(Rf_allocVector(INTSXP, n));
+    copyToInteger<short>(pixels, INTEGER(out), n);
+    break;
+  case GL_INT:
+    out = PROTECT(Rf_allocVector(INTSXP, n));
+    memcpy(INTEGER(out), pixels, n * 4);
+    break;
+  default:
+    if(bytes == 2 && type != GL_HALF_FLOAT) {
+      out = PROTECT(Rf_allocVector(INTSXP, n));
+      copyToInteger<unsigned short>(pixels, INTEGER(out), n);
+    }
+    else if(bytes == 4) {
+      /* Unsigned 32-bit values do not fit R integers */
+      out = PROTECT(Rf_allocVector(REALSXP, n));
+      const unsigned int * src = (const unsigned int *) pixels;
+      double * dst = REAL(out);
+      for (size_t i = 0; i < n; i++) {
+        dst[i] = src[i];
+      }
+    }
+    else {
+      stop("half float pixels are not supported, read them as GL_FLOAT");
+    }
+  }
+  SEXP dim = PROTECT(Rf_allocVector(INTSXP, 3));
+  INTEGER(dim)[0] = values;
+  INTEGER(dim)[1] = width;
+  INTEGER(dim)[2] = height;
+  Rf_setAttrib(out, R_DimSymbol, dim);
+  UNPROTECT(2);
+  return out;
+}
+
+static void waitSlot(ReadbackSlot & slot) {
+  GLenum status = glClientWaitSync(slot.sync, 0, 0);
+  if(status == GL_TIMEOUT_EXPIRED) {
+    readStats.stalls++;
+    do {
+      status = glClientWaitSync(slot.sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    } while(status == GL_TIMEOUT_EXPIRED);
+  }
+  if(status == GL_WAIT_FAILED) {
+    stop("glClientWaitSync failed while waiting on a readback");
+  }
+}
+
+static void freeSlot(ReadbackSlot & slot) {
+  glDeleteSync(slot.sync);
+  slot.sync = 0;
+  slot.ticket = 0;
+}
+
+/* Map a slot's buffer, leaving it bound to the pixel pack target */
+static const unsigned char * mapSlot(ReadbackSlot & slot) {
+  waitSlot(slot);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  const unsigned char * data = (const unsigned char *) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.bytes, GL_MAP_READ_BIT);
+  if(data == NULL) {
+    stop("could not map the pixel pack buffer");
+  }
+  return data;
+}
+
+static GLint packBinding() {
+  GLint buffer;
+  if(!cachedGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &buffer)) {
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &buffer);
+  }
+  return buffer;
+}
+
+static void spill(ReadbackSlot & slot) {
+  GLint buffer = packBinding();
+  const unsigned char * data = mapSlot(slot);
+  SpilledReadback & copy = spilled[slot.ticket];
+  copy.width = slot.width;
+  copy.height = slot.height;
+  copy.format = slot.format;
+  copy.type = slot.type;
+  copy.pixels.assign(data, data + slot.bytes);
+  glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  freeSlot(slot);
+  readStats.spills++;
+}
+
+static ReadbackSlot * findSlot(unsigned long long ticket) {
+  for (size_t i = 0; i < slots.size(); i++) {
+    if(slots[i].ticket == ticket) {
+      return &slots[i];
+    }
+  }
+  return NULL;
+}
+
+unsigned long long readbackStart(int x, int y, int width, int height, GLenum format, GLenum type) {
+  if(width <= 0 || height <= 0) {
+    stop("width and height must be positive");
+  }
+  size_t bytes = pixelBytes(format, type) * width * height;
+  ReadbackSlot * slot = findSlot(0);
+  if(slot == NULL) {
+    for (size_t i = 0; i < slots.size(); i++) {
+      if(&slots[i] != mapped && (slot == NULL || slots[i].ticket < slot->ticket)) {
+        slot = &slots[i];
+      }
+    }
+    if(slot == NULL) {
+      stop("all readback buffers are in use");
+    }
+    spill(*slot);
+  }
+  GLint buffer = packBinding();
+  GLint alignment;
+  glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+  if(slot->buffer == 0) {
+    glGenBuffers(1, &slot->buffer);
+  }
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+  if(slot->capacity < (GLsizeiptr) bytes) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+    slot->capacity = bytes;
+  }
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(x, y, width, height, format, type, (void *) 0);
+  glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  slot->sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  slot->ticket = nextTicket++;
+  slot->width = width;
+  slot->height = height;
+  slot->format = format;
+  slot->type = type;
+  slot->bytes = bytes;
+  readStats.issued++;
+  return slot->ticket;
+}
+
+bool readbackReady(unsigned long long ticket) {
+  if(spilled.count(ticket)) {
+    return true;
+  }
+  ReadbackSlot * slot = findSlot(ticket);
+  if(slot == NULL || ticket == 0) {
+    stop("unknown readback ticket");
+  }
+  GLenum status = glClientWaitSync(slot->sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+const unsigned char * readbackMap(unsigned long long ticket, int * width, int * height, GLenum * format, GLenum * type) {
+  std::map<unsigned long long, SpilledReadback>::iterator copy = spilled.find(ticket);
+  if(copy != spilled.end()) {
+    *width = copy->second.width;
+    *height = copy->second.height;
+    *format = copy->second.format;
+    *type = copy->second.type;
+    return &copy->second.pixels[0];
+  }
+  ReadbackSlot * slot = findSlot(ticket);
+  if(slot == NULL || ticket == 0) {
+    stop("unknown readback ticket");
+  }
+  if(mapped != NULL) {
+    stop("another readback is still mapped");
+  }
+  GLint buffer = packBinding();
+  const unsigned char * data = mapSlot(*slot);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  mapped = slot;
+  *width = slot->width;
+  *height = slot->height;
+  *format = slot->format;
+  *type = slot->type;
+  return data;
+}
+
+void readbackRelease(unsigned long long ticket) {
+  if(spilled.erase(ticket)) {
+    readStats.collected++;
+    return;
+  }
+  ReadbackSlot * slot = findSlot(ticket);
+  if(slot == NULL || ticket == 0) {
+    return;
+  }
+  if(slot == mapped) {
+    GLint buffer = packBinding();
+    cachedBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    cachedBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    mapped = NULL;
+  }
+  freeSlot(*slot);
+  readStats.collected++;
+}
+
+//' Start an asynchronous framebuffer read
+//'
+//' The pixels are copied into a pixel buffer object on the GPU's schedule; rendering
+//' goes on and readPixelsResult collects them later, ideally a frame or two on.
+//' @param x left edge
+//' @param y bottom edge
+//' @param width width in pixels
+//' @param height height in pixels
+//' @param format pixel format such as GL_RGBA
+//' @param type component type such as GL_UNSIGNED_BYTE or GL_FLOAT
+//' @return ticket for readPixelsResult
+//' @export
+// [[Rcpp::export]]
+double readPixelsAsync(int x, int y, int width, int height, unsigned int format = 0x1908, unsigned int type = 0x1401) {
+  return (double) readbackStart(x, y, width, height, format, type);
+}
+
+//' Whether an asynchronous read has finished
+//' @param ticket from readPixelsAsync
+//' @export
+// [[Rcpp::export]]
+bool readPixelsReady(double ticket) {
+  return readbackReady((unsigned long long) ticket);
+}
+
+//' Collect an asynchronous read
+//' @param ticket from readPixelsAsync
+//' @param wait block until the read has finished; otherwise NULL is returned if it has not
+//' @return array with dim c(values per pixel, width, height), bottom row first: raw for
+//' GL_UNSIGNED_BYTE, numeric for GL_FLOAT and unsigned 32-bit types, integer otherwise
+//' @export
+// [[Rcpp::export]]
+SEXP readPixelsResult(double ticket, bool wait = true) {
+  unsigned long long id = (unsigned long long) ticket;
+  if(!wait && !readbackReady(id)) {
+    return R_NilValue;
+  }
+  int width, height;
+  GLenum format, type;
+  const unsigned char * pixels = readbackMap(id, &width, &height, &format, &type);
+  SEXP out;
+  try {
+    out = pixelVector(pixels, width, height, format, type);
+  }
+  catch(...) {
+    readbackRelease(id);
+    throw;
+  }
+  readbackRelease(id);
+  return out;
+}
+
+//' Read the framebuffer into a nativeRaster
+//'
+//' The result can be drawn with graphics::rasterImage or grid::grid.raster, or written
+//' with png::writePNG, without any conversion in R. Rows are flipped to top first.
+//' @param x left edge
+//' @param y bottom edge
+//' @param width width in pixels, 0 for the whole framebuffer
+//' @param height height in pixels, 0 for the whole framebuffer
+//' @param opaque set alpha to 255, for framebuffers whose alpha channel is not
+//' meaningful
+//' @return nativeRaster integer matrix
+//' @export
+// [[Rcpp::export]]
+IntegerMatrix readNativeRaster(int x = 0, int y = 0, int width = 0, int height = 0, bool opaque = true) {
+  if(width <= 0 || height <= 0) {
+    int fullWidth, fullHeight;
+    defaultFramebufferSize(&fullWidth, &fullHeight);
+    if(width <= 0) {
+      width = fullWidth - x;
+    }
+    if(height <= 0) {
+      height = fullHeight - y;
+    }
+  }
+  if(width <= 0 || height <= 0) {
+    stop("nothing to read");
+  }
+  IntegerMatrix out(height, width);
+  unsigned int * pixels = (unsigned int *) INTEGER(out);
+  GLint buffer = packBinding();
+  GLint alignment;
+  glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+  glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+  cachedBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  /* one pass flips the rows and, when asked, forces alpha; the middle row only needs the alpha */
+  unsigned int alpha = opaque ? 0xFF000000u : 0;
+  for (int row = 0; row <= height - 1 - row; row++) {
+    if(row < height - 1 - row || alpha != 0) {
+      swapRows(pixels + (size_t) row * width, pixels + (size_t) (height - 1 - row) * width, width, alpha);
+    }
+  }
+  out.attr("class") = "nativeRaster";
+  out.attr("channels") = 4;
+  return out;
+}
+
+//' Set the number of pixel buffers used for asynchronous reads
+//'
+//' Reads still in flight are collected into host memory first.
+//' @param n number of buffers, at least one more than the reads usually in flight
+//' @export
+// [[Rcpp::export]]
+void setReadbackBuffers(int n) {
+  if(n < 1) {
+    stop("n must be positive");
+  }
+  if(mapped != NULL) {
+    stop("a readback is still mapped");
+  }
+  for (size_t i = 0; i < slots.size(); i++) {
+    if(slots[i].ticket != 0) {
+      spill(slots[i]);
+    }
+    if(slots[i].buffer != 0) {
+      cachedDeleteBuffers(1, &slots[i].buffer);
+    }
+  }
+  slots.assign(n, ReadbackSlot());
+}
+
+//' Asynchronous readback statistics
+//' @param reset zero the counters after reading them
+//' @return list with reads issued and collected, collections that had to wait for the
+//' GPU, and reads copied out early because every buffer was in use
+//' @export
+// [[Rcpp::export]]
+List readbackStats(bool reset = false) {
+  List out = List::create(_["issued"] = readStats.issued,
+                          _["collected"] = readStats.collected,
+                          _["stalls"] = readStats.stalls,
+                          _["spills"] = readStats.spills);
+  if(reset) {
+    memset(&readStats, 0, sizeof readStats);
+  }
+  return out;
+}
@@ -0,0 +1,24 @@
+#ifndef ROPENGL_READBACK_H
+#define ROPENGL_READBACK_H
+
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <stddef.h>
+
+/*
+ * Framebuffer readback, see readback.cpp. pixelBytes is the tightly packed size of one
+ * pixel, pixelVector copies tightly packed pixels into a new R array (raw for unsigned
+ * bytes, integer or numeric otherwise) with dim c(values per pixel, width, height).
+ *
+ * readbackStart issues an asynchronous read into the pixel buffer ring and returns its
+ * ticket; readbackMap waits for it and returns the pixels, valid until readbackRelease.
+ */
+size_t pixelBytes(GLenum format, GLenum type);
+SEXP pixelVector(const void * pixels, int width, int height, GLenum format, GLenum type);
+
+unsigned long long readbackStart(int x, int y, int width, int height, GLenum format, GLenum type);
+bool readbackReady(unsigned long long ticket);
+const unsigned char * readbackMap(unsigned long long ticket, int * width, int * height, GLenum * format, GLenum * type);
+void readbackRelease(unsigned long long ticket);
+
+#endif
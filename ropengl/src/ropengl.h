@@ -0,0 +1,20 @@
+#ifndef ROPENGL_H
+#define ROPENGL_H
+
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+/* Shared between the package's translation units, defined in gl.cpp */
+extern GLFWwindow * window;
+glm::mat4 asMat4(Rcpp::NumericMatrix mat);
+Rcpp::NumericMatrix asNumericMatrix(glm::mat4 mat, int col, int row);
+glm::vec3 asVec3(Rcpp::NumericVector vec);
+void initFlagMap();
+
+/* Native mat4 / vec3 handles, defined in matrix.cpp */
+glm::mat4 * mat4Ptr(SEXP m);
+glm::vec3 vec3Arg(SEXP v);
+
+#endif
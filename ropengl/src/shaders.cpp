@@ -0,0 +1,334 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <ctype.h>
+#include <map>
+#include <set>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "mapped.h"
+#include "shaders.h"
+using namespace Rcpp;
+
+/*
+ * Shader source preprocessing. loadShaderSource maps the file, splices in #include
+ * "file" / <file> directives (quoted names are looked up next to the including file
+ * first, then in includeDirs) and drops files marked #pragma once after their first
+ * inclusion. Every included file gets its own GLSL source number through #line, so
+ * compiler messages point at the right file and line; mapShaderLog turns those numbers
+ * back into paths.
+ *
+ * Results are cached per root file and include path. An entry lists every file it
+ * read with its size, mtime and content hash: unchanged stat data is a hit without any
+ * reads, and a touched file whose contents hash the same still is.
+ */
+unsigned long long hashBytes(const void * data, size_t size, unsigned long long seed) {
+  const unsigned char * p = (const unsigned char *) data;
+  unsigned long long hash = seed;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ p[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+struct SourceDependency {
+  std::string path;
+  double mtime;
+  double size;
+  unsigned long long hash;
+};
+
+struct PreprocessedSource {
+  std::vector<SourceDependency> dependencies;
+  std::string source;
+  std::vector<std::string> files;
+};
+
+struct Preprocessor {
+  std::vector<std::string> includeDirs;
+  std::vector<std::string> stack;
+  std::set<std::string> once;
+  PreprocessedSource out;
+};
+
+static std::map<std::string, PreprocessedSource> sourceCache;
+static std::map<unsigned long long, std::vector<std::string> > filesBySource;
+static std::map<GLuint, std::vector<std::string> > shaderFiles;
+
+static bool fileStat(const std::string & path, double * mtime, double * size) {
+  struct stat st;
+  if(stat(path.c_str(), &st) != 0 || (st.st_mode & S_IFDIR)) {
+    return false;
+  }
+  *mtime = (double) st.st_mtime;
+  *size = (double) st.st_size;
+  return true;
+}
+
+static std::string directoryOf(const std::string & path) {
+  size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+}
+
+/* Collapse "." and "dir/.." so one file included two ways is still one file */
+static std::string normalizePath(const std::string & path) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\');
+  while(start <= path.size()) {
+    size_t slash = path.find_first_of("/\\", start);
+    if(slash == std::string::npos) {
+      slash = path.size();
+    }
+    std::string part = path.substr(start, slash - start);
+    if(part == "..") {
+      if(!parts.empty() && parts.back() != "..") {
+        parts.pop_back();
+      }
+      else if(!absolute) {
+        parts.push_back(part);
+      }
+    }
+    else if(!part.empty() && part != ".") {
+      parts.push_back(part);
+    }
+    start = slash + 1;
+  }
+  std::string out = absolute ? "/" : "";
+  for (size_t i = 0; i < parts.size(); i++) {
+    out += (i > 0 ? "/" : "") + parts[i];
+  }
+  return out;
+}
+
+static std::string resolveInclude(Preprocessor & pp, const std::string & from, const std::string & name, bool quoted) {
+  double mtime, size;
+  if(quoted && fileStat(directoryOf(from) + name, &mtime, &size)) {
+    return normalizePath(directoryOf(from) + name);
+  }
+  for (size_t i = 0; i < pp.includeDirs.size(); i++) {
+    std::string candidate = pp.includeDirs[i] + "/" + name;
+    if(fileStat(candidate, &mtime, &size)) {
+      return normalizePath(candidate);
+    }
+  }
+  return "";
+}
+
+static std::string lineDirective(int line, int file) {
+  char buffer[48];
+  snprintf(buffer, sizeof buffer, "#line %d %d\n", line, file);
+  return buffer;
+}
+
+/* The directive name of a preprocessor line, with `rest` pointing after it */
+static std::string directive(const char * begin, const char * end, const char ** rest) {
+  const char * p = begin;
+  while(p < end && (*p == ' ' || *p == '\t')) {
+    p++;
+  }
+  if(p == end || *p != '#') {
+    return "";
+  }
+  p++;
+  while(p < end && (*p == ' ' || *p == '\t')) {
+    p++;
+  }
+  const char * word = p;
+  while(p < end && isalpha((unsigned char) *p)) {
+    p++;
+  }
+  *rest = p;
+  return std::string(word, p);
+}
+
+static void preprocess(Preprocessor & pp, const std::string & path, const std::string & from, int fromLine) {
+  std::string where = from.empty() ? path : from + ":" + std::to_string(fromLine);
+  if(std::find(pp.stack.begin(), pp.stack.end(), path) != pp.stack.end()) {
+    stop(where + ": recursive #include of " + path);
+  }
+  if(pp.stack.size() >= 32) {
+    stop(where + ": #include nested too deeply");
+  }
+  MappedFile file(path);
+  SourceDependency dependency;
+  if(!file.ok() || !fileStat(path, &dependency.mtime, &dependency.size)) {
+    stop(where + ": " + path + " could not be opened");
+  }
+  dependency.path = path;
+  dependency.hash = hashBytes(file.data(), file.size());
+  pp.out.dependencies.push_back(dependency);
+  int id = pp.out.files.size();
+  pp.out.files.push_back(path);
+  pp.stack.push_back(path);
+  std::string & out = pp.out.source;
+  if(id > 0) {
+    out += lineDirective(1, id);
+  }
+  const char * p = (const char *) file.data();
+  const char * end = p + file.size();
+  for (int line = 1; p < end; line++) {
+    const char * eol = (const char *) memchr(p, '\n', end - p);
+    const char * next = eol ? eol + 1 : end;
+    if(!eol) {
+      eol = end;
+    }
+    if(eol > p && eol[-1] == '\r') {
+      eol--;
+    }
+    const char * rest;
+    std::string name = directive(p, eol, &rest);
+    if(name == "include") {
+      while(rest < eol && (*rest == ' ' || *rest == '\t')) {
+        rest++;
+      }
+      char close = rest < eol && *rest == '"' ? '"' : rest < eol && *rest == '<' ? '>' : 0;
+      const char * nameEnd = close ? (const char *) memchr(rest + 1, close, eol - rest - 1) : NULL;
+      if(nameEnd == NULL) {
+        stop(path + ":" + std::to_string(line) + ": malformed #include");
+      }
+      std::string included(rest + 1, nameEnd);
+      std::string resolved = resolveInclude(pp, path, included, close == '"');
+      if(resolved.empty()) {
+        stop(path + ":" + std::to_string(line) + ": " + included + " not found");
+      }
+      if(pp.once.count(resolved)) {
+        out += "\n";
+      }
+      else {
+        preprocess(pp, resolved, path, line);
+        out += lineDirective(line + 1, id);
+      }
+    }
+    else if(name == "pragma" && std::string(rest, eol).find("once") != std::string::npos) {
+      pp.once.insert(path);
+      out += "\n";
+    }
+    else if(name == "version" && id > 0) {
+      out += "\n";
+    }
+    else {
+      out.append(p, eol);
+      out += "\n";
+    }
+    p = next;
+  }
+  pp.stack.pop_back();
+}
+
+/* Whether every file a cached result was built from still has the same contents */
+static bool upToDate(PreprocessedSource & cached) {
+  for (size_t i = 0; i < cached.dependencies.size(); i++) {
+    SourceDependency & dependency = cached.dependencies[i];
+    double mtime, size;
+    if(!fileStat(dependency.path, &mtime, &size)) {
+      return false;
+    }
+    if(mtime == dependency.mtime && size == dependency.size) {
+      continue;
+    }
+    MappedFile file(dependency.path);
+    if(!file.ok() || hashBytes(file.data(), file.size()) != dependency.hash) {
+      return false;
+    }
+    dependency.mtime = mtime;
+    dependency.size = size;
+  }
+  return true;
+}
+
+const std::string & preprocessShaderFile(const std::string & path, const std::vector<std::string> & includeDirs, std::vector<std::string> * files, bool reload) {
+  std::string key = path;
+  for (size_t i = 0; i < includeDirs.size(); i++) {
+    key += "\n" + includeDirs[i];
+  }
+  std::map<std::string, PreprocessedSource>::iterator cached = sourceCache.find(key);
+  if(reload || cached == sourceCache.end() || !upToDate(cached->second)) {
+    Preprocessor pp;
+    pp.includeDirs = includeDirs;
+    preprocess(pp, path, "", 0);
+    cached = sourceCache.insert(std::make_pair(key, PreprocessedSource())).first;
+    cached->second = pp.out;
+    const std::string & source = cached->second.source;
+    filesBySource[hashBytes(source.data(), source.size())] = cached->second.files;
+  }
+  if(files != NULL) {
+    *files = cached->second.files;
+  }
+  return cached->second.source;
+}
+
+//' Load a shader source file, resolving #include directives
+//'
+//' Included files are spliced in with #line directives giving each file its own source
+//' number; glGetShaderInfoLog maps those back to file names for shaders compiled from
+//' the result. Files containing #pragma once are included only once. Results are cached
+//' until one of the files involved changes.
+//' @param path shader source file
+//' @param includeDirs directories searched for included files
+//' @return the preprocessed source, with the files behind each source number in the
+//' "files" attribute
+//' @export
+// [[Rcpp::export]]
+CharacterVector loadShaderSource(std::string path, CharacterVector includeDirs = CharacterVector::create()) {
+  std::vector<std::string> files;
+  CharacterVector out = CharacterVector::create(preprocessShaderFile(path, as<std::vector<std::string> >(includeDirs), &files, false));
+  out.attr("files") = wrap(files);
+  return out;
+}
+
+void noteShaderSource(GLuint shader, const std::string & source) {
+  std::map<unsigned long long, std::vector<std::string> >::iterator files = filesBySource.find(hashBytes(source.data(), source.size()));
+  if(files != filesBySource.end()) {
+    shaderFiles[shader] = files->second;
+  }
+  else {
+    shaderFiles.erase(shader);
+  }
+}
+
+void forgetShaderSource(GLuint shader) {
+  shaderFiles.erase(shader);
+}
+
+/*
+ * Replace the source number in front of each line's first "N(line)" or "N:line"
+ * location (the NVIDIA, Mesa and AMD spellings) with the file it stands for.
+ */
+std::string mapShaderLog(GLuint shader, const std::string & log) {
+  std::map<GLuint, std::vector<std::string> >::iterator found = shaderFiles.find(shader);
+  if(found == shaderFiles.end()) {
+    return log;
+  }
+  const std::vector<std::string> & files = found->second;
+  std::string out;
+  size_t start = 0;
+  while(start < log.size()) {
+    size_t eol = log.find('\n', start);
+    eol = eol == std::string::npos ? log.size() : eol + 1;
+    std::string line = log.substr(start, eol - start);
+    for (size_t i = 0; i < line.size(); i++) {
+      if(!isdigit((unsigned char) line[i]) || (i > 0 && isalnum((unsigned char) line[i - 1]))) {
+        continue;
+      }
+      size_t j = i;
+      while(j < line.size() && isdigit((unsigned char) line[j])) {
+        j++;
+      }
+      if(j + 1 < line.size() && (line[j] == '(' || line[j] == ':') && isdigit((unsigned char) line[j + 1])) {
+        size_t number = atoi(line.substr(i, j - i).c_str());
+        if(number < files.size()) {
+          line.replace(i, j - i, files[number]);
+        }
+        break;
+      }
+      i = j;
+    }
+    out += line;
+    start = eol;
+  }
+  return out;
+}
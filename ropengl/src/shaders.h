@@ -0,0 +1,31 @@
+#ifndef ROPENGL_SHADERS_H
+#define ROPENGL_SHADERS_H
+
+#include <glad/glad.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/* 64 bit FNV-1a, the content hash used by the shader caches */
+unsigned long long hashBytes(const void * data, size_t size, unsigned long long seed = 14695981039346656037ULL);
+
+/*
+ * loadShaderSource without the R wrapping: the preprocessed source of `path`, with the
+ * files it was built from in `files` when given. `reload` skips the cache.
+ */
+const std::string & preprocessShaderFile(const std::string & path, const std::vector<std::string> & includeDirs, std::vector<std::string> * files, bool reload);
+
+/*
+ * Shader source bookkeeping, see shaders.cpp. glShaderSource reports every source it
+ * hands to GL so info logs of shaders built from loadShaderSource output can name the
+ * original files instead of #line source numbers.
+ */
+void noteShaderSource(GLuint shader, const std::string & source);
+void forgetShaderSource(GLuint shader);
+std::string mapShaderLog(GLuint shader, const std::string & log);
+
+/* Hot reload, see hotreload.cpp: relink watched programs whose files changed */
+int reloadChangedPrograms();
+void unwatchProgram(GLuint program);
+
+#endif
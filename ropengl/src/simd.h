@@ -0,0 +1,93 @@
+#ifndef ROPENGL_SIMD_H
+#define ROPENGL_SIMD_H
+
+#include <stddef.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* R hands us doubles, GL wants floats / uints: narrow n values from src into dst */
+inline void narrowToFloat(const double * src, float * dst, size_t n) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 4 <= n; i += 4) {
+    __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+    __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+    _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+  }
+#endif
+  for (; i < n; i++) {
+    dst[i] = (float) src[i];
+  }
+}
+
+/*
+ * GL names and counts run up to 2^32 - 1 but SSE2 only truncates to signed ints, so lanes
+ * at or above 2^31 are converted 2^31 lower and get the top bit back afterwards. Both
+ * paths clamp to [0, 2^32 - 1] first, NaN going to 0, so they agree on every input.
+ */
+inline void narrowToUint(const double * src, unsigned int * dst, size_t n) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128d bias = _mm_set1_pd(2147483648.0);
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d limit = _mm_set1_pd(4294967295.0);
+  const __m128i top = _mm_set1_epi32((int) 0x80000000);
+  for (; i + 4 <= n; i += 4) {
+    __m128i half[2];
+    for (int j = 0; j < 2; j++) {
+      /* maxpd returns its second operand for NaN */
+      __m128d v = _mm_min_pd(_mm_max_pd(_mm_loadu_pd(src + i + j * 2), zero), limit);
+      __m128d big = _mm_cmpge_pd(v, bias);
+      __m128i r = _mm_cvttpd_epi32(_mm_sub_pd(v, _mm_and_pd(big, bias)));
+      __m128i mask = _mm_shuffle_epi32(_mm_castpd_si128(big), _MM_SHUFFLE(3, 3, 2, 0));
+      half[j] = _mm_xor_si128(r, _mm_and_si128(mask, top));
+    }
+    _mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi64(half[0], half[1]));
+  }
+#endif
+  for (; i < n; i++) {
+    double v = src[i] > 0 ? src[i] : 0;
+    dst[i] = (unsigned int) (v < 4294967295.0 ? v : 4294967295.0);
+  }
+}
+
+/* The other way round, for pixels read back as floats */
+inline void widenFloat(const float * src, double * dst, size_t n) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 4 <= n; i += 4) {
+    __m128 v = _mm_loadu_ps(src + i);
+    _mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+    _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+#endif
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+/*
+ * Exchange two rows of n RGBA pixels, for flipping an image upside down in place, and
+ * OR alpha (0 or 0xFF000000) into every pixel on the way. With a == b the row stays
+ * put and only gets the alpha.
+ */
+inline void swapRows(unsigned int * a, unsigned int * b, size_t n, unsigned int alpha) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i mask = _mm_set1_epi32((int) alpha);
+  for (; i + 4 <= n; i += 4) {
+    __m128i x = _mm_loadu_si128((const __m128i *) (a + i));
+    __m128i y = _mm_loadu_si128((const __m128i *) (b + i));
+    _mm_storeu_si128((__m128i *) (a + i), _mm_or_si128(y, mask));
+    _mm_storeu_si128((__m128i *) (b + i), _mm_or_si128(x, mask));
+  }
+#endif
+  for (; i < n; i++) {
+    unsigned int t = a[i];
+    a[i] = b[i] | alpha;
+    b[i] = t | alpha;
+  }
+}
+
+#endif
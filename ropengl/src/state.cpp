@@ -0,0 +1,560 @@
+#include <Rcpp.h>
+#include <map>
+#include <string.h>
+#include "state.h"
+using namespace Rcpp;
+
+/*
+ * Shadow of the GL state the wrappers, command buffers and stream buffers change.
+ * Each slot holds up to four words plus whether it is known at all; unknown slots
+ * (after invalidateStateCache, or a VAO switch for the element array binding) are
+ * always forwarded and become known again on the next set. Right after createWindow
+ * every binding is 0 and every capability is off, so `fresh` lets slots that were
+ * never touched be answered from the GL defaults.
+ */
+struct Shadow {
+  GLuint v[4];
+  bool known;
+};
+
+struct StateStats {
+  double binds;
+  double programs;
+  double caps;
+  double blend;
+  double depth;
+  double stencil;
+  double faces;
+  double queries;
+  double forwarded;
+};
+
+static bool tracking = false;
+static bool fresh = false;
+static std::map<GLenum, Shadow> buffers;
+static std::map<unsigned long long, Shadow> textures;
+static std::map<GLenum, Shadow> caps;
+static Shadow activeTexture, program, vertexArray, drawFramebuffer, readFramebuffer, renderbuffer;
+static Shadow blendColor, blendEquation, blendFunc, depthFunc, depthMask, cullFace, frontFace;
+static Shadow stencilFunc[2], stencilOp[2], stencilMask[2];
+static StateStats stats;
+
+static void known(Shadow & s, GLuint a, GLuint b = 0, GLuint c = 0, GLuint d = 0) {
+  s.v[0] = a;
+  s.v[1] = b;
+  s.v[2] = c;
+  s.v[3] = d;
+  s.known = true;
+}
+
+/* Store the new value, returning true when GL has to be told about it */
+static bool update(Shadow & s, GLuint a, GLuint b = 0, GLuint c = 0, GLuint d = 0) {
+  if(s.known && s.v[0] == a && s.v[1] == b && s.v[2] == c && s.v[3] == d) {
+    return false;
+  }
+  known(s, a, b, c, d);
+  return true;
+}
+
+static bool updateFaces(Shadow * s, GLenum face, GLuint a, GLuint b, GLuint c) {
+  bool changed = false;
+  if(face != GL_BACK) {
+    changed = update(s[0], a, b, c) || changed;
+  }
+  if(face != GL_FRONT) {
+    changed = update(s[1], a, b, c) || changed;
+  }
+  return changed;
+}
+
+template <typename K> static Shadow & slot(std::map<K, Shadow> & m, K key) {
+  typename std::map<K, Shadow>::iterator it = m.find(key);
+  if(it == m.end()) {
+    Shadow s = { { 0, 0, 0, 0 }, fresh };
+    it = m.insert(std::make_pair(key, s)).first;
+  }
+  return it->second;
+}
+
+template <typename K> static const Shadow * lookup(std::map<K, Shadow> & m, K key) {
+  static const Shadow zero = { { 0, 0, 0, 0 }, true };
+  typename std::map<K, Shadow>::iterator it = m.find(key);
+  if(it != m.end()) {
+    return &it->second;
+  }
+  return fresh ? &zero : NULL;
+}
+
+static unsigned long long textureKey(GLenum unit, GLenum target) {
+  return (unsigned long long) unit << 32 | target;
+}
+
+static void forget() {
+  buffers.clear();
+  textures.clear();
+  caps.clear();
+  Shadow * all[] = { &activeTexture, &program, &vertexArray, &drawFramebuffer, &readFramebuffer,
+                     &renderbuffer, &blendColor, &blendEquation, &blendFunc, &depthFunc, &depthMask,
+                     &cullFace, &frontFace, &stencilFunc[0], &stencilFunc[1], &stencilOp[0],
+                     &stencilOp[1], &stencilMask[0], &stencilMask[1] };
+  for (size_t i = 0; i < sizeof all / sizeof all[0]; i++) {
+    all[i]->known = false;
+  }
+  fresh = false;
+}
+
+/* A new context was made current: everything is at its GL default */
+void cachedReset() {
+  forget();
+  if(!tracking) {
+    return;
+  }
+  fresh = true;
+  known(activeTexture, GL_TEXTURE0);
+  known(program, 0);
+  known(vertexArray, 0);
+  known(drawFramebuffer, 0);
+  known(readFramebuffer, 0);
+  known(renderbuffer, 0);
+  known(blendColor, 0, 0, 0, 0);
+  known(blendEquation, GL_FUNC_ADD, GL_FUNC_ADD);
+  known(blendFunc, GL_ONE, GL_ZERO, GL_ONE, GL_ZERO);
+  known(depthFunc, GL_LESS);
+  known(depthMask, GL_TRUE);
+  known(cullFace, GL_BACK);
+  known(frontFace, GL_CCW);
+  for (int i = 0; i < 2; i++) {
+    known(stencilFunc[i], GL_ALWAYS, 0, ~0u);
+    known(stencilOp[i], GL_KEEP, GL_KEEP, GL_KEEP);
+    known(stencilMask[i], ~0u);
+  }
+  known(slot(caps, (GLenum) GL_DITHER), GL_TRUE);
+  known(slot(caps, (GLenum) GL_MULTISAMPLE), GL_TRUE);
+}
+
+static GLenum currentUnit() {
+  if(!activeTexture.known) {
+    GLint unit;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &unit);
+    known(activeTexture, unit);
+  }
+  return activeTexture.v[0];
+}
+
+void cachedActiveTexture(GLenum unit) {
+  if(tracking) {
+    if(!update(activeTexture, unit)) {
+      stats.binds++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glActiveTexture(unit);
+}
+
+void cachedBindBuffer(GLenum target, GLuint buffer) {
+  if(tracking) {
+    if(!update(slot(buffers, target), buffer)) {
+      stats.binds++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glBindBuffer(target, buffer);
+}
+
+void cachedBindTexture(GLenum target, GLuint texture) {
+  if(tracking) {
+    if(!update(slot(textures, textureKey(currentUnit(), target)), texture)) {
+      stats.binds++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glBindTexture(target, texture);
+}
+
+void cachedBindVertexArray(GLuint array) {
+  if(tracking) {
+    if(!update(vertexArray, array)) {
+      stats.binds++;
+      return;
+    }
+    /* the element array binding belongs to the VAO */
+    slot(buffers, (GLenum) GL_ELEMENT_ARRAY_BUFFER).known = false;
+    stats.forwarded++;
+  }
+  glBindVertexArray(array);
+}
+
+void cachedBindFramebuffer(GLenum target, GLuint framebuffer) {
+  if(tracking) {
+    bool changed = false;
+    if(target != GL_READ_FRAMEBUFFER) {
+      changed = update(drawFramebuffer, framebuffer) || changed;
+    }
+    if(target != GL_DRAW_FRAMEBUFFER) {
+      changed = update(readFramebuffer, framebuffer) || changed;
+    }
+    if(!changed) {
+      stats.binds++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glBindFramebuffer(target, framebuffer);
+}
+
+void cachedBindRenderbuffer(GLenum target, GLuint renderbuffer_) {
+  if(tracking) {
+    if(!update(renderbuffer, renderbuffer_)) {
+      stats.binds++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glBindRenderbuffer(target, renderbuffer_);
+}
+
+void cachedUseProgram(GLuint program_) {
+  if(tracking) {
+    if(!update(program, program_)) {
+      stats.programs++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glUseProgram(program_);
+}
+
+void cachedEnable(GLenum cap) {
+  if(tracking) {
+    if(!update(slot(caps, cap), GL_TRUE)) {
+      stats.caps++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glEnable(cap);
+}
+
+void cachedDisable(GLenum cap) {
+  if(tracking) {
+    if(!update(slot(caps, cap), GL_FALSE)) {
+      stats.caps++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glDisable(cap);
+}
+
+void cachedBlendColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+  if(tracking) {
+    GLuint bits[4];
+    GLfloat rgba[4] = { r, g, b, a };
+    memcpy(bits, rgba, sizeof bits);
+    if(!update(blendColor, bits[0], bits[1], bits[2], bits[3])) {
+      stats.blend++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glBlendColor(r, g, b, a);
+}
+
+void cachedBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) {
+  if(tracking) {
+    if(!update(blendEquation, modeRGB, modeAlpha)) {
+      stats.blend++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glBlendEquationSeparate(modeRGB, modeAlpha);
+}
+
+void cachedBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+  if(tracking) {
+    if(!update(blendFunc, srcRGB, dstRGB, srcAlpha, dstAlpha)) {
+      stats.blend++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+void cachedDepthFunc(GLenum func) {
+  if(tracking) {
+    if(!update(depthFunc, func)) {
+      stats.depth++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glDepthFunc(func);
+}
+
+void cachedDepthMask(GLboolean flag) {
+  if(tracking) {
+    if(!update(depthMask, flag ? GL_TRUE : GL_FALSE)) {
+      stats.depth++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glDepthMask(flag);
+}
+
+void cachedStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask) {
+  if(tracking) {
+    if(!updateFaces(stencilFunc, face, func, ref, mask)) {
+      stats.stencil++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glStencilFuncSeparate(face, func, ref, mask);
+}
+
+void cachedStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) {
+  if(tracking) {
+    if(!updateFaces(stencilOp, face, sfail, dpfail, dppass)) {
+      stats.stencil++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glStencilOpSeparate(face, sfail, dpfail, dppass);
+}
+
+void cachedStencilMaskSeparate(GLenum face, GLuint mask) {
+  if(tracking) {
+    if(!updateFaces(stencilMask, face, mask, 0, 0)) {
+      stats.stencil++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glStencilMaskSeparate(face, mask);
+}
+
+void cachedCullFace(GLenum mode) {
+  if(tracking) {
+    if(!update(cullFace, mode)) {
+      stats.faces++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glCullFace(mode);
+}
+
+void cachedFrontFace(GLenum mode) {
+  if(tracking) {
+    if(!update(frontFace, mode)) {
+      stats.faces++;
+      return;
+    }
+    stats.forwarded++;
+  }
+  glFrontFace(mode);
+}
+
+/* GL unbinds deleted objects from the current context, so bindings to them become 0 */
+template <typename K> static void unbind(std::map<K, Shadow> & m, GLsizei n, const GLuint * names) {
+  for (typename std::map<K, Shadow>::iterator it = m.begin(); it != m.end(); ++it) {
+    for (GLsizei i = 0; i < n; i++) {
+      if(names[i] != 0 && it->second.known && it->second.v[0] == names[i]) {
+        it->second.v[0] = 0;
+      }
+    }
+  }
+}
+
+static void unbind(Shadow & s, GLsizei n, const GLuint * names) {
+  for (GLsizei i = 0; i < n; i++) {
+    if(names[i] != 0 && s.known && s.v[0] == names[i]) {
+      s.v[0] = 0;
+    }
+  }
+}
+
+void cachedDeleteBuffers(GLsizei n, const GLuint * names) {
+  unbind(buffers, n, names);
+  glDeleteBuffers(n, names);
+}
+
+void cachedDeleteTextures(GLsizei n, const GLuint * names) {
+  unbind(textures, n, names);
+  glDeleteTextures(n, names);
+}
+
+void cachedDeleteVertexArrays(GLsizei n, const GLuint * names) {
+  GLuint bound = vertexArray.v[0];
+  unbind(vertexArray, n, names);
+  if(vertexArray.v[0] != bound) {
+    slot(buffers, (GLenum) GL_ELEMENT_ARRAY_BUFFER).known = false;
+  }
+  glDeleteVertexArrays(n, names);
+}
+
+void cachedDeleteFramebuffers(GLsizei n, const GLuint * names) {
+  unbind(drawFramebuffer, n, names);
+  unbind(readFramebuffer, n, names);
+  glDeleteFramebuffers(n, names);
+}
+
+void cachedDeleteRenderbuffers(GLsizei n, const GLuint * names) {
+  unbind(renderbuffer, n, names);
+  glDeleteRenderbuffers(n, names);
+}
+
+static const Shadow * queryBinding(GLenum pname) {
+  switch(pname) {
+  case GL_ARRAY_BUFFER_BINDING:
+    return lookup(buffers, (GLenum) GL_ARRAY_BUFFER);
+  case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+    return lookup(buffers, (GLenum) GL_ELEMENT_ARRAY_BUFFER);
+  case GL_PIXEL_PACK_BUFFER_BINDING:
+    return lookup(buffers, (GLenum) GL_PIXEL_PACK_BUFFER);
+  case GL_PIXEL_UNPACK_BUFFER_BINDING:
+    return lookup(buffers, (GLenum) GL_PIXEL_UNPACK_BUFFER);
+  case GL_UNIFORM_BUFFER_BINDING:
+    return lookup(buffers, (GLenum) GL_UNIFORM_BUFFER);
+  case GL_COPY_READ_BUFFER:
+  case GL_COPY_WRITE_BUFFER:
+    return lookup(buffers, pname);
+  }
+  if(!activeTexture.known) {
+    return NULL;
+  }
+  GLenum unit = activeTexture.v[0];
+  switch(pname) {
+  case GL_TEXTURE_BINDING_1D:
+    return lookup(textures, textureKey(unit, GL_TEXTURE_1D));
+  case GL_TEXTURE_BINDING_2D:
+    return lookup(textures, textureKey(unit, GL_TEXTURE_2D));
+  case GL_TEXTURE_BINDING_3D:
+    return lookup(textures, textureKey(unit, GL_TEXTURE_3D));
+  case GL_TEXTURE_BINDING_CUBE_MAP:
+    return lookup(textures, textureKey(unit, GL_TEXTURE_CUBE_MAP));
+  case GL_TEXTURE_BINDING_1D_ARRAY:
+    return lookup(textures, textureKey(unit, GL_TEXTURE_1D_ARRAY));
+  case GL_TEXTURE_BINDING_2D_ARRAY:
+    return lookup(textures, textureKey(unit, GL_TEXTURE_2D_ARRAY));
+  case GL_TEXTURE_BINDING_RECTANGLE:
+    return lookup(textures, textureKey(unit, GL_TEXTURE_RECTANGLE));
+  }
+  return NULL;
+}
+
+/* Answer a single-valued glGetIntegerv from the shadow if that state is tracked and known */
+bool cachedGetIntegerv(GLenum pname, GLint * data) {
+  if(!tracking) {
+    return false;
+  }
+  const Shadow * s = NULL;
+  int i = 0;
+  switch(pname) {
+  case GL_ACTIVE_TEXTURE: s = &activeTexture; break;
+  case GL_CURRENT_PROGRAM: s = &program; break;
+  case GL_VERTEX_ARRAY_BINDING: s = &vertexArray; break;
+  case GL_DRAW_FRAMEBUFFER_BINDING: s = &drawFramebuffer; break;
+  case GL_READ_FRAMEBUFFER_BINDING: s = &readFramebuffer; break;
+  case GL_RENDERBUFFER_BINDING: s = &renderbuffer; break;
+  case GL_BLEND_EQUATION_RGB: s = &blendEquation; break;
+  case GL_BLEND_EQUATION_ALPHA: s = &blendEquation; i = 1; break;
+  case GL_BLEND_SRC_RGB: s = &blendFunc; break;
+  case GL_BLEND_DST_RGB: s = &blendFunc; i = 1; break;
+  case GL_BLEND_SRC_ALPHA: s = &blendFunc; i = 2; break;
+  case GL_BLEND_DST_ALPHA: s = &blendFunc; i = 3; break;
+  case GL_DEPTH_FUNC: s = &depthFunc; break;
+  case GL_DEPTH_WRITEMASK: s = &depthMask; break;
+  case GL_STENCIL_FUNC: s = &stencilFunc[0]; break;
+  case GL_STENCIL_REF: s = &stencilFunc[0]; i = 1; break;
+  case GL_STENCIL_FAIL: s = &stencilOp[0]; break;
+  case GL_STENCIL_PASS_DEPTH_FAIL: s = &stencilOp[0]; i = 1; break;
+  case GL_STENCIL_PASS_DEPTH_PASS: s = &stencilOp[0]; i = 2; break;
+  case GL_STENCIL_BACK_FUNC: s = &stencilFunc[1]; break;
+  case GL_STENCIL_BACK_REF: s = &stencilFunc[1]; i = 1; break;
+  case GL_STENCIL_BACK_FAIL: s = &stencilOp[1]; break;
+  case GL_STENCIL_BACK_PASS_DEPTH_FAIL: s = &stencilOp[1]; i = 1; break;
+  case GL_STENCIL_BACK_PASS_DEPTH_PASS: s = &stencilOp[1]; i = 2; break;
+  case GL_CULL_FACE_MODE: s = &cullFace; break;
+  case GL_FRONT_FACE: s = &frontFace; break;
+  default:
+    s = queryBinding(pname);
+    if(s == NULL && caps.count(pname)) {
+      s = &caps[pname];
+    }
+  }
+  if(s == NULL || !s->known) {
+    return false;
+  }
+  *data = s->v[i];
+  stats.queries++;
+  return true;
+}
+
+bool cachedIsEnabled(GLenum cap, GLboolean * result) {
+  if(!tracking) {
+    return false;
+  }
+  const Shadow * s = lookup(caps, cap);
+  if(s == NULL || !s->known) {
+    return false;
+  }
+  *result = s->v[0] ? GL_TRUE : GL_FALSE;
+  stats.queries++;
+  return true;
+}
+
+//' Enable or disable the shadow GL state cache
+//'
+//' With the cache on, binds, program switches, glEnable / glDisable and blend, depth,
+//' stencil and face state changes that would leave GL as it is never reach the driver,
+//' and glGetIntegerv / glIsEnabled answer tracked state without a round-trip. Only
+//' changes made through ropengl are seen: call invalidateStateCache after other code
+//' touches the context.
+//' @param enabled TRUE to track state
+//' @export
+// [[Rcpp::export]]
+void setStateCache(bool enabled) {
+  tracking = enabled;
+  forget();
+}
+
+//' Forget all shadowed GL state
+//'
+//' Every tracked call is forwarded again until it has been seen once.
+//' @export
+// [[Rcpp::export]]
+void invalidateStateCache() {
+  forget();
+}
+
+//' State cache statistics
+//' @param reset zero the counters after reading them
+//' @return list with the number of elided binds, program switches, capability toggles,
+//' blend, depth, stencil and face state changes, queries answered from the shadow and
+//' tracked calls that were forwarded to GL
+//' @export
+// [[Rcpp::export]]
+List stateCacheStats(bool reset = false) {
+  List out = List::create(_["enabled"] = tracking,
+                          _["binds"] = stats.binds,
+                          _["programs"] = stats.programs,
+                          _["caps"] = stats.caps,
+                          _["blend"] = stats.blend,
+                          _["depth"] = stats.depth,
+                          _["stencil"] = stats.stencil,
+                          _["faces"] = stats.faces,
+                          _["queries"] = stats.queries,
+                          _["forwarded"] = stats.forwarded);
+  if(reset) {
+    memset(&stats, 0, sizeof stats);
+  }
+  return out;
+}
@@ -0,0 +1,60 @@
+#ifndef ROPENGL_STATE_H
+#define ROPENGL_STATE_H
+
+#include <glad/glad.h>
+
+/*
+ * Shadow GL state, see state.cpp. The cached* setters only reach the driver when the
+ * value differs from what the current context already has, and the query helpers
+ * answer from the shadow, returning false when the caller has to ask GL instead.
+ * With the cache disabled (the default) every setter forwards unconditionally.
+ */
+void cachedReset();
+void cachedActiveTexture(GLenum unit);
+void cachedBindBuffer(GLenum target, GLuint buffer);
+void cachedBindTexture(GLenum target, GLuint texture);
+void cachedBindVertexArray(GLuint array);
+void cachedBindFramebuffer(GLenum target, GLuint framebuffer);
+void cachedBindRenderbuffer(GLenum target, GLuint renderbuffer);
+void cachedUseProgram(GLuint program);
+void cachedEnable(GLenum cap);
+void cachedDisable(GLenum cap);
+void cachedBlendColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+void cachedBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha);
+void cachedBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+void cachedDepthFunc(GLenum func);
+void cachedDepthMask(GLboolean flag);
+void cachedStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask);
+void cachedStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+void cachedStencilMaskSeparate(GLenum face, GLuint mask);
+void cachedCullFace(GLenum mode);
+void cachedFrontFace(GLenum mode);
+void cachedDeleteBuffers(GLsizei n, const GLuint * buffers);
+void cachedDeleteTextures(GLsizei n, const GLuint * textures);
+void cachedDeleteVertexArrays(GLsizei n, const GLuint * arrays);
+void cachedDeleteFramebuffers(GLsizei n, const GLuint * framebuffers);
+void cachedDeleteRenderbuffers(GLsizei n, const GLuint * renderbuffers);
+bool cachedGetIntegerv(GLenum pname, GLint * data);
+bool cachedIsEnabled(GLenum cap, GLboolean * enabled);
+
+inline void cachedBlendEquation(GLenum mode) {
+  cachedBlendEquationSeparate(mode, mode);
+}
+
+inline void cachedBlendFunc(GLenum sfactor, GLenum dfactor) {
+  cachedBlendFuncSeparate(sfactor, dfactor, sfactor, dfactor);
+}
+
+inline void cachedStencilFunc(GLenum func, GLint ref, GLuint mask) {
+  cachedStencilFuncSeparate(GL_FRONT_AND_BACK, func, ref, mask);
+}
+
+inline void cachedStencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) {
+  cachedStencilOpSeparate(GL_FRONT_AND_BACK, sfail, dpfail, dppass);
+}
+
+inline void cachedStencilMask(GLuint mask) {
+  cachedStencilMaskSeparate(GL_FRONT_AND_BACK, mask);
+}
+
+#endif
@@ -0,0 +1,217 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <deque>
+#include <string.h>
+#include "simd.h"
+#include "state.h"
+using namespace Rcpp;
+
+/*
+ * One big GL buffer handed out in per-frame slices. Offsets are tracked on a virtual,
+ * ever-increasing axis (physical = virtual % size) so "has the GPU finished with these
+ * bytes" is a single comparison against the fenced ranges.
+ */
+struct StreamFence {
+  unsigned long long start;
+  GLsync sync;
+};
+
+struct StreamBuffer {
+  GLuint buffer;
+  GLenum target;
+  unsigned long long size;
+  unsigned long long alignment;
+  unsigned long long head;
+  unsigned long long fenceStart;
+  bool orphan;
+  std::deque<StreamFence> fences;
+  int stalls;
+  int orphans;
+};
+
+static size_t streamBytes(SEXP data) {
+  switch(TYPEOF(data)) {
+  case INTSXP:
+  case REALSXP:
+    return XLENGTH(data) * 4;
+  case RAWSXP:
+    return XLENGTH(data);
+  default:
+    stop("stream data must be a numeric, integer or raw vector");
+  }
+  return 0;
+}
+
+static void streamCopy(SEXP data, void * dst, bool elementArray) {
+  size_t n = XLENGTH(data);
+  switch(TYPEOF(data)) {
+  case INTSXP:
+    memcpy(dst, INTEGER(data), n * 4);
+    break;
+  case RAWSXP:
+    memcpy(dst, RAW(data), n);
+    break;
+  case REALSXP:
+    if(elementArray) {
+      narrowToUint(REAL(data), (unsigned int *) dst, n);
+    }
+    else {
+      narrowToFloat(REAL(data), (float *) dst, n);
+    }
+    break;
+  }
+}
+
+static void dropFences(StreamBuffer * s) {
+  for (size_t i = 0; i < s->fences.size(); i++) {
+    glDeleteSync(s->fences[i].sync);
+  }
+  s->fences.clear();
+}
+
+/* Block until every fenced range starting before `limit` has been consumed by the GPU */
+static void waitFences(StreamBuffer * s, unsigned long long limit) {
+  while(!s->fences.empty() && s->fences.front().start < limit) {
+    GLsync sync = s->fences.front().sync;
+    GLenum status = glClientWaitSync(sync, 0, 0);
+    if(status == GL_TIMEOUT_EXPIRED) {
+      s->stalls++;
+      do {
+        status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+      } while(status == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(sync);
+    s->fences.pop_front();
+    if(status == GL_WAIT_FAILED) {
+      stop("glClientWaitSync failed while waiting on stream buffer");
+    }
+  }
+}
+
+static StreamBuffer * streamPtr(SEXP stream) {
+  StreamBuffer * s = XPtr<StreamBuffer>(stream).get();
+  if(s == NULL || s->buffer == 0) {
+    stop("stream buffer has been deleted");
+  }
+  return s;
+}
+
+//' Create a streaming vertex buffer
+//' @param size buffer size in bytes, should hold a few frames worth of data
+//' @param target buffer binding target, GL_ARRAY_BUFFER by default
+//' @param alignment byte alignment of every write, use the vertex stride so offset / stride is a valid first vertex
+//' @param orphan re-specify the buffer store on wrap instead of waiting on fences
+//' @export
+// [[Rcpp::export]]
+SEXP createStreamBuffer(double size, unsigned int target = 0x8892, int alignment = 16, bool orphan = false) {
+  if(size <= 0 || alignment <= 0) {
+    stop("size and alignment must be positive");
+  }
+  StreamBuffer * s = new StreamBuffer();
+  s->target = target;
+  s->size = (unsigned long long) size;
+  s->alignment = alignment;
+  s->head = 0;
+  s->fenceStart = 0;
+  s->orphan = orphan;
+  s->stalls = 0;
+  s->orphans = 0;
+  glGenBuffers(1, &s->buffer);
+  cachedBindBuffer(target, s->buffer);
+  glBufferData(target, s->size, NULL, GL_STREAM_DRAW);
+  return XPtr<StreamBuffer>(s, true);
+}
+
+//' Write a frame's data into a streaming buffer
+//' @param stream stream buffer from createStreamBuffer
+//' @param data numeric (uploaded as float), integer or raw vector
+//' @param elementArray narrow numeric data to unsigned int instead of float
+//' @return byte offset of the data inside the GL buffer
+//' @export
+// [[Rcpp::export]]
+double streamBufferWrite(SEXP stream, SEXP data, bool elementArray = false) {
+  StreamBuffer * s = streamPtr(stream);
+  unsigned long long bytes = streamBytes(data);
+  if(bytes > s->size) {
+    stop("data is larger than the stream buffer");
+  }
+  unsigned long long start = (s->head + s->alignment - 1) / s->alignment * s->alignment;
+  if(start % s->size + bytes > s->size) {
+    start = (start / s->size + 1) * s->size;
+    if(s->orphan) {
+      cachedBindBuffer(s->target, s->buffer);
+      glBufferData(s->target, s->size, NULL, GL_STREAM_DRAW);
+      dropFences(s);
+      s->fenceStart = start;
+      s->orphans++;
+    }
+  }
+  if(start + bytes > s->size) {
+    unsigned long long limit = start + bytes - s->size;
+    if(s->fenceStart < limit) {
+      stop("more data was streamed since the last streamBufferFence than the buffer holds");
+    }
+    waitFences(s, limit);
+  }
+  cachedBindBuffer(s->target, s->buffer);
+  GLintptr offset = start % s->size;
+  void * dst = glMapBufferRange(s->target, offset, bytes,
+                                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  if(dst == NULL) {
+    stop("glMapBufferRange failed on stream buffer");
+  }
+  streamCopy(data, dst, elementArray);
+  glUnmapBuffer(s->target);
+  s->head = start + bytes;
+  return offset;
+}
+
+//' Fence everything written to a stream buffer since the last fence
+//'
+//' Call once per frame after the draws that read the streamed data.
+//' @param stream stream buffer from createStreamBuffer
+//' @export
+// [[Rcpp::export]]
+void streamBufferFence(SEXP stream) {
+  StreamBuffer * s = streamPtr(stream);
+  if(s->head == s->fenceStart) {
+    return;
+  }
+  StreamFence f;
+  f.start = s->fenceStart;
+  f.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  s->fences.push_back(f);
+  s->fenceStart = s->head;
+}
+
+//' GL buffer name behind a stream buffer
+//' @param stream stream buffer from createStreamBuffer
+//' @export
+// [[Rcpp::export]]
+unsigned int streamBufferId(SEXP stream) {
+  return streamPtr(stream)->buffer;
+}
+
+//' Stream buffer statistics
+//' @param stream stream buffer from createStreamBuffer
+//' @return list with size, in-flight fence count, writes that had to wait on the GPU and orphan count
+//' @export
+// [[Rcpp::export]]
+List streamBufferStats(SEXP stream) {
+  StreamBuffer * s = streamPtr(stream);
+  return List::create(_["size"] = (double) s->size,
+                      _["inFlight"] = (int) s->fences.size(),
+                      _["stalls"] = s->stalls,
+                      _["orphans"] = s->orphans);
+}
+
+//' Delete a stream buffer and its fences
+//' @param stream stream buffer from createStreamBuffer
+//' @export
+// [[Rcpp::export]]
+void deleteStreamBuffer(SEXP stream) {
+  StreamBuffer * s = streamPtr(stream);
+  dropFences(s);
+  cachedDeleteBuffers(1, &s->buffer);
+  s->buffer = 0;
+}
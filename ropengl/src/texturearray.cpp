@@ -0,0 +1,146 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string.h>
+#include "state.h"
+#include "textures.h"
+using namespace Rcpp;
+
+/*
+ * GL_TEXTURE_2D_ARRAY loading, one RGBA layer per image. Files are decoded `batch` at a
+ * time on the texture workers; while one batch is copied into a contiguous staging
+ * buffer and sent with a single glTexSubImage3D, the next one is already decoding.
+ * Mipmaps are generated once for the whole array at the end.
+ */
+static bool hasImageExtension(const std::string & name) {
+  static const char * extensions[] = { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".psd", ".hdr", ".pic", ".pnm", ".ppm", ".pgm" };
+  size_t dot = name.find_last_of('.');
+  if(dot == std::string::npos) {
+    return false;
+  }
+  std::string ext = name.substr(dot);
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  for (size_t i = 0; i < sizeof extensions / sizeof extensions[0]; i++) {
+    if(ext == extensions[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::vector<std::string> listImages(const std::string & dir) {
+  std::vector<std::string> files;
+  DIR * d = opendir(dir.c_str());
+  if(d == NULL) {
+    stop(dir + ": directory could not be opened");
+  }
+  struct dirent * entry;
+  while((entry = readdir(d)) != NULL) {
+    if(hasImageExtension(entry->d_name)) {
+      files.push_back(dir + "/" + entry->d_name);
+    }
+  }
+  closedir(d);
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+static std::shared_ptr<ImageBatch> decodeLayers(const std::vector<std::string> & paths, size_t first, size_t count) {
+  std::vector<std::string> slice(paths.begin() + first, paths.begin() + std::min(paths.size(), first + count));
+  return decodeImages(slice, 4);
+}
+
+/* Empty when every image in the batch decoded at the expected size */
+static std::string checkLayers(ImageBatch & batch, int width, int height) {
+  for (size_t i = 0; i < batch.images.size(); i++) {
+    DecodedImage & image = batch.images[i];
+    if(image.pixels == NULL) {
+      return image.error;
+    }
+    if(image.width != width || image.height != height) {
+      return image.path + ": is " + std::to_string(image.width) + "x" + std::to_string(image.height) +
+        ", the array layers are " + std::to_string(width) + "x" + std::to_string(height);
+    }
+  }
+  return "";
+}
+
+//' Load same-sized images into a 2D texture array
+//'
+//' @param paths image files, or a single directory whose images are loaded in name order
+//' @param mipmaps generate mipmaps for the whole array after uploading
+//' @param batch number of layers decoded and uploaded together
+//' @return list with the GL texture name, the layer size and the file of every layer
+//' @export
+// [[Rcpp::export]]
+List loadTextureArray(std::vector<std::string> paths, bool mipmaps = true, int batch = 16) {
+  struct stat st;
+  if(paths.size() == 1 && stat(paths[0].c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+    paths = listImages(paths[0]);
+  }
+  if(paths.empty()) {
+    stop("no images given");
+  }
+  batch = std::max(batch, 1);
+  std::shared_ptr<ImageBatch> current = decodeLayers(paths, 0, batch);
+  waitImages(*current);
+  DecodedImage & first = current->images[0];
+  int width = first.width, height = first.height;
+  std::string error = checkLayers(*current, width, height);
+  if(!error.empty()) {
+    freeImages(*current);
+    stop(error);
+  }
+  GLuint texture;
+  GLint bound, buffer;
+  if(!cachedGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &bound)) {
+    glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &bound);
+  }
+  if(!cachedGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer)) {
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer);
+  }
+  glGenTextures(1, &texture);
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  cachedBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, paths.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  size_t layerBytes = (size_t) width * height * 4;
+  std::vector<unsigned char> staging(layerBytes * current->images.size());
+  for (size_t layer = 0; error.empty(); layer += batch) {
+    std::shared_ptr<ImageBatch> next;
+    if(layer + batch < paths.size()) {
+      next = decodeLayers(paths, layer + batch, batch);
+    }
+    size_t count = current->images.size();
+    for (size_t i = 0; i < count; i++) {
+      memcpy(&staging[i * layerBytes], current->images[i].pixels, layerBytes);
+    }
+    freeImages(*current);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, count, GL_RGBA, GL_UNSIGNED_BYTE, &staging[0]);
+    if(!next) {
+      break;
+    }
+    current = next;
+    waitImages(*current);
+    error = checkLayers(*current, width, height);
+  }
+  if(!error.empty()) {
+    freeImages(*current);
+    cachedBindTexture(GL_TEXTURE_2D_ARRAY, bound);
+    cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    cachedDeleteTextures(1, &texture);
+    stop(error);
+  }
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  if(mipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  }
+  else {
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  }
+  cachedBindTexture(GL_TEXTURE_2D_ARRAY, bound);
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+  return List::create(_["texture"] = texture, _["width"] = width, _["height"] = height, _["paths"] = paths);
+}
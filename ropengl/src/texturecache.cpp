@@ -0,0 +1,226 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <list>
+#include <map>
+#include <string.h>
+#include <sys/stat.h>
+#include "stb_image.h"
+#include "state.h"
+#include "textures.h"
+using namespace Rcpp;
+
+/*
+ * Texture cache shared by loadTexture and loadTextureAsync. Entries are keyed by path
+ * and remember the file's mtime and whether mipmaps were generated, so a repeat load
+ * of an unchanged file returns the texture already on the GPU and a changed file (or
+ * a different mipmaps setting) is re-uploaded into the same name. `lru` is ordered
+ * most recently used first; once the cached byte count passes the budget the oldest
+ * entries are evicted and their textures deleted, so the budget bounds what the cache
+ * keeps on the GPU. Byte counts are estimates: 3 channel images are counted at 4 bytes
+ * per texel as drivers pad them, mipmaps add a third.
+ */
+struct CacheEntry {
+  std::string path;
+  double mtime;
+  bool mipmaps;
+  GLuint texture;
+  double bytes;
+};
+
+typedef std::list<CacheEntry>::iterator CacheIterator;
+
+static std::list<CacheEntry> lru;
+static std::map<std::string, CacheIterator> byPath;
+static double residentBytes = 0;
+static double cacheBudget = 256.0 * 1024 * 1024;
+
+static struct {
+  double hits;
+  double misses;
+  double evictions;
+} cacheStats;
+
+double textureMtime(const std::string & path) {
+  struct stat st;
+  if(stat(path.c_str(), &st) != 0) {
+    return -1;
+  }
+  return (double) st.st_mtime;
+}
+
+double textureBytes(int width, int height, int channels, bool mipmaps) {
+  double bytes = (double) width * height * (channels == 3 ? 4 : channels);
+  return mipmaps ? bytes * 4 / 3 : bytes;
+}
+
+static void evict(CacheIterator it) {
+  GLuint texture = it->texture;
+  residentBytes -= it->bytes;
+  byPath.erase(it->path);
+  lru.erase(it);
+  cachedDeleteTextures(1, &texture);
+  cacheStats.evictions++;
+}
+
+/* Drop least recently used entries until the budget holds, never the front one */
+static void enforceBudget() {
+  while(residentBytes > cacheBudget && lru.size() > 1) {
+    evict(--lru.end());
+  }
+}
+
+GLuint textureCacheLookup(const std::string & path, double mtime, bool mipmaps) {
+  std::map<std::string, CacheIterator>::iterator found = byPath.find(path);
+  if(found == byPath.end() || found->second->mtime != mtime || found->second->mipmaps != mipmaps) {
+    cacheStats.misses++;
+    return 0;
+  }
+  lru.splice(lru.begin(), lru, found->second);
+  cacheStats.hits++;
+  return found->second->texture;
+}
+
+GLuint textureCacheStale(const std::string & path) {
+  std::map<std::string, CacheIterator>::iterator found = byPath.find(path);
+  return found == byPath.end() ? 0 : found->second->texture;
+}
+
+GLuint textureCacheTake(const std::string & path) {
+  std::map<std::string, CacheIterator>::iterator found = byPath.find(path);
+  if(found == byPath.end()) {
+    return 0;
+  }
+  GLuint texture = found->second->texture;
+  residentBytes -= found->second->bytes;
+  lru.erase(found->second);
+  byPath.erase(found);
+  return texture;
+}
+
+void textureCacheInsert(const std::string & path, double mtime, bool mipmaps, GLuint texture, double bytes) {
+  std::map<std::string, CacheIterator>::iterator found = byPath.find(path);
+  if(found != byPath.end()) {
+    GLuint replaced = found->second->texture;
+    residentBytes -= found->second->bytes;
+    lru.erase(found->second);
+    if(replaced != texture) {
+      cachedDeleteTextures(1, &replaced);
+    }
+  }
+  CacheEntry entry = { path, mtime, mipmaps, texture, bytes };
+  lru.push_front(entry);
+  byPath[path] = lru.begin();
+  residentBytes += bytes;
+  enforceBudget();
+}
+
+void textureCacheForget(GLsizei n, const GLuint * textures) {
+  if(lru.empty()) {
+    return;
+  }
+  for (GLsizei i = 0; i < n; i++) {
+    for (CacheIterator it = lru.begin(); it != lru.end(); ++it) {
+      if(it->texture == textures[i]) {
+        residentBytes -= it->bytes;
+        byPath.erase(it->path);
+        lru.erase(it);
+        break;
+      }
+    }
+  }
+}
+
+//' Load an image file into a cached texture
+//'
+//' Repeat loads of an unchanged file with the same mipmaps setting return the texture
+//' that is already resident; a file modified since it was cached, or asked for with
+//' the other mipmaps setting, is decoded again into the same texture name. Textures
+//' evicted by the budget are deleted, so call loadTexture again rather than keeping
+//' the name across other loads.
+//' @param path image file readable by stb_image
+//' @param mipmaps generate mipmaps after uploading
+//' @return GL texture name
+//' @export
+// [[Rcpp::export]]
+unsigned int loadTexture(std::string path, bool mipmaps = true) {
+  double mtime = textureMtime(path);
+  if(mtime < 0) {
+    stop(path + ": file not found");
+  }
+  GLuint texture = textureCacheLookup(path, mtime, mipmaps);
+  if(texture != 0) {
+    return texture;
+  }
+  int width, height, chan;
+  unsigned char * data = stbi_load(path.c_str(), &width, &height, &chan, 0);
+  if(data == NULL) {
+    stop(path + ": " + stbi_failure_reason());
+  }
+  texture = textureCacheStale(path);
+  if(texture == 0) {
+    glGenTextures(1, &texture);
+  }
+  GLenum internalFormat, format;
+  GLint bound, alignment;
+  if(!cachedGetIntegerv(GL_TEXTURE_BINDING_2D, &bound)) {
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+  }
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  textureFormats(chan, &internalFormat, &format);
+  cachedBindTexture(GL_TEXTURE_2D, texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  stbi_image_free(data);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  if(mipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  }
+  else {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  }
+  cachedBindTexture(GL_TEXTURE_2D, bound);
+  textureCacheInsert(path, mtime, mipmaps, texture, textureBytes(width, height, chan, mipmaps));
+  return texture;
+}
+
+//' Set the texture cache budget
+//'
+//' Least recently loaded textures are evicted and deleted once the cached textures
+//' exceed it. The most recent load is always kept.
+//' @param bytes resident texture memory allowed
+//' @export
+// [[Rcpp::export]]
+void setTextureCacheBudget(double bytes) {
+  cacheBudget = bytes;
+  enforceBudget();
+}
+
+//' Delete every cached texture
+//' @export
+// [[Rcpp::export]]
+void clearTextureCache() {
+  while(!lru.empty()) {
+    evict(lru.begin());
+  }
+}
+
+//' Texture cache statistics
+//' @param reset zero the hit, miss and eviction counters after reading them
+//' @return list with hits, misses, evictions, the number of cached textures, their
+//' estimated bytes and the budget
+//' @export
+// [[Rcpp::export]]
+List textureCacheStats(bool reset = false) {
+  List out = List::create(_["hits"] = cacheStats.hits,
+                          _["misses"] = cacheStats.misses,
+                          _["evictions"] = cacheStats.evictions,
+                          _["textures"] = (int) lru.size(),
+                          _["bytes"] = residentBytes,
+                          _["budget"] = cacheBudget);
+  if(reset) {
+    memset(&cacheStats, 0, sizeof cacheStats);
+  }
+  return out;
+}
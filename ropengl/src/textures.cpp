@@ -0,0 +1,415 @@
+#include <Rcpp.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include "stb_image.h"
+#include "state.h"
+#include "textures.h"
+using namespace Rcpp;
+
+/*
+ * Asynchronous texture loading. loadTextureAsync creates the GL texture right away
+ * and queues the file for a pool of decode threads; decoded images wait in `decoded`
+ * until the GL thread uploads them through a pixel unpack buffer, a bounded number of
+ * bytes per flip(). Decoding never touches GL or R, uploading only happens on the R
+ * thread; failed decodes go through the same queue so their texture name is deleted
+ * there. waitTexture sleeps on `decodedReady` until its decode is done. stb_image's
+ * failure string is a shared global, so with several workers the reason attached to a
+ * failed load is best effort.
+ */
+enum TextureState {
+  TEXTURE_QUEUED,
+  TEXTURE_DECODED,
+  TEXTURE_READY,
+  TEXTURE_FAILED
+};
+
+struct TextureLoad {
+  std::string path;
+  double mtime;
+  bool mipmaps;
+  GLuint texture;
+  std::atomic<int> state;
+  unsigned char * pixels;
+  int width;
+  int height;
+  int channels;
+  std::string error;
+};
+
+typedef std::shared_ptr<TextureLoad> TextureHandle;
+
+static std::mutex poolMutex;
+static std::condition_variable poolWake;
+static std::deque<std::function<void()> > jobs;
+static std::vector<std::thread> workers;
+static bool stopping = false;
+
+static std::mutex decodedMutex;
+static std::condition_variable decodedReady;
+static std::deque<TextureHandle> decoded;
+static std::atomic<int> pendingUploads(0);
+/* Loads still queued or decoding, so repeat requests for a file share one */
+static std::map<std::string, std::weak_ptr<TextureLoad> > inFlight;
+static double uploadBudget = 16 * 1024 * 1024;
+static GLuint unpackBuffer = 0;
+
+static void workerLoop() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(poolMutex);
+      poolWake.wait(lock, [] { return stopping || !jobs.empty(); });
+      if(jobs.empty()) {
+        return;
+      }
+      job.swap(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+
+/* Joins the workers when the package library is unloaded */
+static struct TexturePool {
+  ~TexturePool() {
+    {
+      std::lock_guard<std::mutex> lock(poolMutex);
+      stopping = true;
+      jobs.clear();
+    }
+    poolWake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+      workers[i].join();
+    }
+  }
+} texturePool;
+
+void textureWorkerSubmit(std::function<void()> job) {
+  std::lock_guard<std::mutex> lock(poolMutex);
+  if(workers.empty()) {
+    int n = std::max(1, std::min(4, (int) std::thread::hardware_concurrency()));
+    for (int i = 0; i < n; i++) {
+      workers.push_back(std::thread(workerLoop));
+    }
+  }
+  jobs.push_back(job);
+  poolWake.notify_one();
+}
+
+void textureWorkerParallel(size_t n, std::function<void(size_t, size_t)> body) {
+  std::shared_ptr<ImageBatch> wait = std::make_shared<ImageBatch>();
+  size_t chunks = std::min(n, (size_t) std::max(1, (int) std::thread::hardware_concurrency()) * 4);
+  if(chunks == 0) {
+    return;
+  }
+  wait->remaining = chunks;
+  for (size_t i = 0; i < chunks; i++) {
+    size_t begin = n * i / chunks, end = n * (i + 1) / chunks;
+    textureWorkerSubmit([wait, body, begin, end] {
+      body(begin, end);
+      std::lock_guard<std::mutex> lock(wait->mutex);
+      if(--wait->remaining == 0) {
+        wait->done.notify_all();
+      }
+    });
+  }
+  waitImages(*wait);
+}
+
+void textureFormats(int channels, GLenum * internalFormat, GLenum * format) {
+  switch(channels) {
+  case 1:
+    *internalFormat = GL_R8;
+    *format = GL_RED;
+    break;
+  case 2:
+    *internalFormat = GL_RG8;
+    *format = GL_RG;
+    break;
+  case 3:
+    *internalFormat = GL_RGB8;
+    *format = GL_RGB;
+    break;
+  default:
+    *internalFormat = GL_RGBA8;
+    *format = GL_RGBA;
+  }
+}
+
+static void decodeImage(std::shared_ptr<ImageBatch> batch, size_t i, int channels) {
+  DecodedImage & image = batch->images[i];
+  int chan;
+  image.pixels = stbi_load(image.path.c_str(), &image.width, &image.height, &chan, channels);
+  if(image.pixels == NULL) {
+    const char * reason = stbi_failure_reason();
+    image.error = image.path + ": " + (reason ? reason : "could not be decoded");
+  }
+  std::lock_guard<std::mutex> lock(batch->mutex);
+  if(--batch->remaining == 0) {
+    batch->done.notify_all();
+  }
+}
+
+std::shared_ptr<ImageBatch> decodeImages(const std::vector<std::string> & paths, int channels) {
+  std::shared_ptr<ImageBatch> batch = std::make_shared<ImageBatch>();
+  batch->images.resize(paths.size());
+  batch->remaining = paths.size();
+  for (size_t i = 0; i < paths.size(); i++) {
+    batch->images[i].path = paths[i];
+    batch->images[i].pixels = NULL;
+  }
+  for (size_t i = 0; i < paths.size(); i++) {
+    textureWorkerSubmit(std::bind(decodeImage, batch, i, channels));
+  }
+  return batch;
+}
+
+void waitImages(ImageBatch & batch) {
+  std::unique_lock<std::mutex> lock(batch.mutex);
+  batch.done.wait(lock, [&] { return batch.remaining == 0; });
+}
+
+void freeImages(ImageBatch & batch) {
+  for (size_t i = 0; i < batch.images.size(); i++) {
+    stbi_image_free(batch.images[i].pixels);
+    batch.images[i].pixels = NULL;
+  }
+}
+
+/* Failed decodes are queued too, so the GL thread can delete their texture names */
+static void decodeTexture(TextureHandle load) {
+  load->pixels = stbi_load(load->path.c_str(), &load->width, &load->height, &load->channels, 0);
+  if(load->pixels == NULL) {
+    const char * reason = stbi_failure_reason();
+    load->error = load->path + ": " + (reason ? reason : "could not be decoded");
+    load->width = load->height = load->channels = 0;
+  }
+  std::lock_guard<std::mutex> lock(decodedMutex);
+  decoded.push_back(load);
+  pendingUploads++;
+  load->state = TEXTURE_DECODED;
+  decodedReady.notify_all();
+}
+
+static void failTexture(TextureLoad * load) {
+  cachedDeleteTextures(1, &load->texture);
+  load->texture = 0;
+  load->state = TEXTURE_FAILED;
+}
+
+/* Copy the pixels through the unpack buffer into the texture, bindings are the caller's */
+static void uploadTexture(TextureLoad * load) {
+  if(load->pixels == NULL) {
+    failTexture(load);
+    return;
+  }
+  GLenum internalFormat, format;
+  textureFormats(load->channels, &internalFormat, &format);
+  GLsizeiptr bytes = (GLsizeiptr) load->width * load->height * load->channels;
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+  void * dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if(dst != NULL) {
+    memcpy(dst, load->pixels, bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  }
+  stbi_image_free(load->pixels);
+  load->pixels = NULL;
+  if(dst == NULL) {
+    load->error = load->path + ": could not map the pixel unpack buffer";
+    failTexture(load);
+    return;
+  }
+  cachedBindTexture(GL_TEXTURE_2D, load->texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, load->width, load->height, 0, format, GL_UNSIGNED_BYTE, (void *) 0);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  if(load->mipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  }
+  else {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  }
+  if(load->mtime >= 0) {
+    textureCacheInsert(load->path, load->mtime, load->mipmaps, load->texture, textureBytes(load->width, load->height, load->channels, load->mipmaps));
+  }
+  load->state = TEXTURE_READY;
+}
+
+/*
+ * Upload decoded images in order until `budget` bytes have gone through (at least one
+ * image per call so a huge one cannot stall forever), or only `only` when given.
+ * Texture, unpack buffer and alignment state are restored afterwards.
+ */
+static int uploadDecoded(double budget, TextureLoad * only) {
+  if(pendingUploads == 0) {
+    return 0;
+  }
+  std::vector<TextureHandle> batch;
+  {
+    std::lock_guard<std::mutex> lock(decodedMutex);
+    double used = 0;
+    for (std::deque<TextureHandle>::iterator it = decoded.begin(); it != decoded.end(); ) {
+      if(only == NULL && !batch.empty() && used >= budget) {
+        break;
+      }
+      if(only != NULL && it->get() != only) {
+        ++it;
+        continue;
+      }
+      used += (double) (*it)->width * (*it)->height * (*it)->channels;
+      batch.push_back(*it);
+      it = decoded.erase(it);
+      pendingUploads--;
+      if(only != NULL) {
+        break;
+      }
+    }
+  }
+  if(batch.empty()) {
+    return 0;
+  }
+  GLint texture, buffer, alignment;
+  if(!cachedGetIntegerv(GL_TEXTURE_BINDING_2D, &texture)) {
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+  }
+  if(!cachedGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer)) {
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer);
+  }
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  if(unpackBuffer == 0) {
+    glGenBuffers(1, &unpackBuffer);
+  }
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpackBuffer);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for (size_t i = 0; i < batch.size(); i++) {
+    uploadTexture(batch[i].get());
+    std::map<std::string, std::weak_ptr<TextureLoad> >::iterator found = inFlight.find(batch[i]->path);
+    if(found != inFlight.end() && found->second.lock() == batch[i]) {
+      inFlight.erase(found);
+    }
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  cachedBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+  cachedBindTexture(GL_TEXTURE_2D, texture);
+  return batch.size();
+}
+
+int uploadPendingTextures(double budget) {
+  return uploadDecoded(budget < 0 ? uploadBudget : budget, NULL);
+}
+
+static TextureHandle texturePtr(SEXP handle) {
+  TextureHandle * p = XPtr<TextureHandle>(handle).get();
+  if(p == NULL) {
+    stop("invalid texture handle");
+  }
+  return *p;
+}
+
+//' Load a texture file in the background
+//'
+//' The GL texture is created immediately; the image is decoded on a worker thread
+//' and uploaded by flip() (or processTextureUploads) once decoded. Files already in
+//' the texture cache are ready at once, see loadTexture; a file that is still loading
+//' is not decoded twice, both handles share the one texture.
+//' @param path image file readable by stb_image
+//' @param mipmaps generate mipmaps after uploading
+//' @return texture handle for textureReady, textureId and waitTexture
+//' @export
+// [[Rcpp::export]]
+SEXP loadTextureAsync(std::string path, bool mipmaps = true) {
+  TextureHandle load = std::make_shared<TextureLoad>();
+  load->path = path;
+  load->mipmaps = mipmaps;
+  load->mtime = textureMtime(path);
+  load->pixels = NULL;
+  load->width = load->height = load->channels = 0;
+  load->texture = load->mtime < 0 ? 0 : textureCacheLookup(path, load->mtime, mipmaps);
+  if(load->texture != 0) {
+    load->state = TEXTURE_READY;
+    return XPtr<TextureHandle>(new TextureHandle(load), true);
+  }
+  std::map<std::string, std::weak_ptr<TextureLoad> >::iterator found = inFlight.find(path);
+  if(found != inFlight.end()) {
+    TextureHandle pending = found->second.lock();
+    if(pending && pending->mtime == load->mtime && pending->mipmaps == mipmaps &&
+       (pending->state == TEXTURE_QUEUED || pending->state == TEXTURE_DECODED)) {
+      return XPtr<TextureHandle>(new TextureHandle(pending), true);
+    }
+    inFlight.erase(found);
+  }
+  if(load->mtime >= 0) {
+    inFlight[path] = load;
+  }
+  load->state = TEXTURE_QUEUED;
+  load->texture = load->mtime < 0 ? 0 : textureCacheTake(path);
+  if(load->texture == 0) {
+    glGenTextures(1, &load->texture);
+  }
+  textureWorkerSubmit(std::bind(decodeTexture, load));
+  return XPtr<TextureHandle>(new TextureHandle(load), true);
+}
+
+//' Whether an asynchronously loaded texture has been uploaded
+//' @param handle texture handle from loadTextureAsync
+//' @export
+// [[Rcpp::export]]
+bool textureReady(SEXP handle) {
+  TextureHandle load = texturePtr(handle);
+  if(load->state == TEXTURE_FAILED) {
+    stop(load->error);
+  }
+  return load->state == TEXTURE_READY;
+}
+
+//' @export
+// [[Rcpp::export]]
+unsigned int textureId(SEXP handle) {
+  return texturePtr(handle)->texture;
+}
+
+//' Block until a texture is decoded and upload it now
+//' @param handle texture handle from loadTextureAsync
+//' @return the GL texture name
+//' @export
+// [[Rcpp::export]]
+unsigned int waitTexture(SEXP handle) {
+  TextureHandle load = texturePtr(handle);
+  {
+    std::unique_lock<std::mutex> lock(decodedMutex);
+    decodedReady.wait(lock, [&] { return load->state != TEXTURE_QUEUED; });
+  }
+  if(load->state == TEXTURE_DECODED) {
+    uploadDecoded(0, load.get());
+  }
+  if(load->state == TEXTURE_FAILED) {
+    stop(load->error);
+  }
+  return load->texture;
+}
+
+//' Upload decoded textures now
+//'
+//' flip() does this every frame with the budget from setTextureUploadBudget.
+//' @param budget bytes to upload, negative for the configured budget
+//' @return number of textures uploaded
+//' @export
+// [[Rcpp::export]]
+int processTextureUploads(double budget = -1) {
+  return uploadPendingTextures(budget);
+}
+
+//' @export
+// [[Rcpp::export]]
+void setTextureUploadBudget(double bytes) {
+  uploadBudget = bytes;
+}
@@ -0,0 +1,66 @@
+#ifndef ROPENGL_TEXTURES_H
+#define ROPENGL_TEXTURES_H
+
+#include <glad/glad.h>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* Unsized / sized GL formats for 1-4 channel 8-bit images */
+void textureFormats(int channels, GLenum * internalFormat, GLenum * format);
+
+/* Run a job on the texture decode workers, see textures.cpp */
+void textureWorkerSubmit(std::function<void()> job);
+
+/*
+ * Decode several files on the workers at once: decodeImages queues them, waitImages
+ * blocks until all have finished, freeImages releases the pixels. A failed image has
+ * NULL pixels and its reason in `error`.
+ */
+struct DecodedImage {
+  std::string path;
+  unsigned char * pixels;
+  int width;
+  int height;
+  std::string error;
+};
+
+struct ImageBatch {
+  std::vector<DecodedImage> images;
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t remaining;
+};
+
+std::shared_ptr<ImageBatch> decodeImages(const std::vector<std::string> & paths, int channels);
+void waitImages(ImageBatch & batch);
+void freeImages(ImageBatch & batch);
+
+/* Run body(begin, end) over [0, n) split across the workers and wait for it */
+void textureWorkerParallel(size_t n, std::function<void(size_t, size_t)> body);
+
+/* KTX / DDS upload, see compressed.cpp */
+unsigned int loadCompressedTexture(std::string path);
+
+/* Per-frame step called from flip(): upload decoded images within the budget */
+int uploadPendingTextures(double budget);
+
+/*
+ * Texture cache, see texturecache.cpp. Lookups return 0 on a miss; textureCacheStale
+ * returns the name cached for a path regardless of mtime so a reload can reuse it.
+ * Eviction deletes textures, so a load that reuses the name later, after decoding,
+ * takes it out of the cache with textureCacheTake and inserts it again when done.
+ * textureCacheForget must see every texture deleted behind the cache's back.
+ */
+double textureMtime(const std::string & path);
+double textureBytes(int width, int height, int channels, bool mipmaps);
+GLuint textureCacheLookup(const std::string & path, double mtime, bool mipmaps);
+GLuint textureCacheStale(const std::string & path);
+GLuint textureCacheTake(const std::string & path);
+void textureCacheInsert(const std::string & path, double mtime, bool mipmaps, GLuint texture, double bytes);
+void textureCacheForget(GLsizei n, const GLuint * textures);
+
+#endif